@@ -0,0 +1,96 @@
+// Base64 throughput: the library codec against a naive byte-at-a-time one.
+//
+//   cmake -S . -B build -DBUILD_BENCHMARKS=ON && cmake --build build --target bench_base64
+//   ./build/bench_base64 [size_mb]
+
+#include "base64.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+
+const std::string ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string naive_encode(const std::string& data) {
+    std::string out;
+    int bits = 0;
+    unsigned int accumulator = 0;
+    for (unsigned char c : data) {
+        accumulator = (accumulator << 8) | c;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            out += ALPHABET[(accumulator >> bits) & 0x3F];
+        }
+    }
+    if (bits > 0) out += ALPHABET[(accumulator << (6 - bits)) & 0x3F];
+    while (out.size() % 4) out += '=';
+    return out;
+}
+
+std::string naive_decode(const std::string& text) {
+    std::string out;
+    int bits = 0;
+    unsigned int accumulator = 0;
+    for (char c : text) {
+        if (c == '=') break;
+        accumulator = (accumulator << 6) | static_cast<unsigned int>(ALPHABET.find(c));
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out += static_cast<char>((accumulator >> bits) & 0xFF);
+        }
+    }
+    return out;
+}
+
+template <typename F>
+double best_seconds(int rounds, F&& f) {
+    double best = 1e30;
+    for (int i = 0; i < rounds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+void report(const char* label, size_t bytes, double seconds) {
+    std::printf("  %-16s %8.3f ms  %7.2f GB/s\n", label, seconds * 1e3, bytes / seconds / 1e9);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t size = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16) * 1024 * 1024;
+    const int rounds = 5;
+
+    std::string data(size, '\0');
+    std::mt19937_64 rng(42);
+    for (auto& c : data) c = static_cast<char>(rng());
+
+    std::string encoded;
+    std::string decoded;
+    std::string naive_encoded;
+    std::string naive_decoded;
+
+    std::printf("base64 %zu MiB, kernel: %s\n", size >> 20, base64_backend());
+
+    std::printf("encode (throughput of input bytes)\n");
+    report("naive", size, best_seconds(rounds, [&] { naive_encoded = naive_encode(data); }));
+    report(base64_backend(), size, best_seconds(rounds, [&] { encoded = base64_encode(data); }));
+
+    std::printf("decode (throughput of encoded bytes)\n");
+    report("naive", encoded.size(), best_seconds(rounds, [&] { naive_decoded = naive_decode(encoded); }));
+    report(base64_backend(), encoded.size(), best_seconds(rounds, [&] { decoded = base64_decode(encoded); }));
+
+    if (encoded != naive_encoded || decoded != data || naive_decoded != data) {
+        std::fprintf(stderr, "MISMATCH between implementations\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// List encodings: table and TSV output against json::dump() of the same
+// list, as returned inline (compact) and by tools/call (indented).
+//
+//   cmake -S . -B build -DBUILD_BENCHMARKS=ON && cmake --build build --target bench_table
+//   ./build/bench_table [rows]
+
+#include "table_encoder.hpp"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using json = nlohmann::json;
+
+namespace {
+
+std::string object_id(std::mt19937_64& rng) {
+    static const char HEX[] = "0123456789abcdef";
+    std::string id(24, '0');
+    for (auto& c : id) c = HEX[rng() % 16];
+    return id;
+}
+
+// Rows shaped like list_audits entries
+json make_audits(size_t rows) {
+    std::mt19937_64 rng(42);
+    static const char* const TYPES[] = {"Web", "Internal", "External", "Mobile"};
+    json items = json::array();
+    for (size_t i = 0; i < rows; ++i) {
+        items.push_back({
+            {"_id", object_id(rng)},
+            {"name", i % 10 ? "Audit " + std::to_string(i) : "Audit \"" + std::to_string(i) + "\"\tR\u00e9vision\n"},
+            {"auditType", TYPES[rng() % 4]},
+            {"language", "en"},
+            {"client", {{"_id", object_id(rng)}, {"name", "Client " + std::to_string(rng() % 50)}}},
+            {"company", {{"_id", object_id(rng)}, {"name", "Company " + std::to_string(rng() % 20)}}},
+            {"collaborators", json::array()},
+            {"reviewers", json::array()},
+            {"date", "2024-0" + std::to_string(1 + rng() % 9) + "-1" + std::to_string(rng() % 10)},
+            {"state", "EDIT"}
+        });
+    }
+    return {{"status", "success"}, {"datas", items}};
+}
+
+template <typename F>
+double best_seconds(int rounds, F&& f) {
+    double best = 1e30;
+    for (int i = 0; i < rounds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+void report(const char* label, size_t bytes, size_t baseline, double seconds) {
+    std::printf("  %-16s %10zu bytes  %5.1f%%  %8.3f ms\n", label, bytes, 100.0 * bytes / baseline, seconds * 1e3);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+    const int rounds = 5;
+    json response = make_audits(rows);
+
+    std::string compact, indented, table, tsv;
+    double compact_time = best_seconds(rounds, [&] { compact = response.dump(); });
+    double indented_time = best_seconds(rounds, [&] { indented = response.dump(2); });
+    double table_time = best_seconds(rounds, [&] { table.clear(); encode_table(response, table); });
+    double tsv_time = best_seconds(rounds, [&] { tsv.clear(); encode_tsv(response, tsv); });
+
+    std::printf("%zu list_audits rows (size relative to dump())\n", rows);
+    report("dump()", compact.size(), compact.size(), compact_time);
+    report("dump(2)", indented.size(), compact.size(), indented_time);
+    report("table", table.size(), compact.size(), table_time);
+    report("tsv", tsv.size(), compact.size(), tsv_time);
+
+    // The table must decode to the same rows
+    json decoded = json::parse(table);
+    const json& items = response["datas"];
+    bool same = decoded["rows"].size() == rows && decoded["status"] == response["status"];
+    for (size_t row = 0; same && row < rows; ++row) {
+        for (size_t i = 0; same && i < decoded["columns"].size(); ++i) {
+            same = decoded["rows"][row][i] == items[row][decoded["columns"][i].get<std::string>()];
+        }
+    }
+    if (!same || decoded["columns"].size() != items[0].size()) {
+        std::fprintf(stderr, "MISMATCH in table output\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Base64 codec. Encoding and decoding use SSSE3 or AVX2 kernels when the
+ * CPU supports them (detected once at runtime) and portable code otherwise;
+ * all paths produce identical output.
+ */
+
+/**
+ * Name of the kernel in use: "avx2", "ssse3" or "scalar"
+ */
+const char* base64_backend();
+
+/**
+ * Length of the padded base64 encoding of `size` bytes
+ */
+size_t base64_encoded_size(size_t size);
+
+/**
+ * Encode `size` bytes into `out`, which must have room for
+ * base64_encoded_size(size) characters. Returns the number written.
+ */
+size_t base64_encode(const uint8_t* data, size_t size, char* out);
+
+/**
+ * Encode a byte string
+ */
+std::string base64_encode(const std::string& data);
+
+/**
+ * Decode padded or unpadded base64 into `out`, which must have room for
+ * size / 4 * 3 + 3 bytes. Returns the number of bytes written; throws
+ * std::invalid_argument on characters outside the alphabet.
+ */
+size_t base64_decode(const char* text, size_t size, uint8_t* out);
+
+/**
+ * Decode a base64 string
+ */
+std::string base64_decode(const std::string& text);
+
+/**
+ * Append the base64 encoding of a file to `out`, reading it in chunks so
+ * that only the encoded form is ever held in memory. Returns the number of
+ * bytes read from the file.
+ */
+size_t base64_append_file(const std::string& path, std::string& out);
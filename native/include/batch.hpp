@@ -0,0 +1,15 @@
+#pragma once
+
+#include "client.hpp"
+#include <nlohmann/json.hpp>
+
+/**
+ * Execute the `batch` tool: run many sub-tool calls through execute_tool
+ * with bounded parallelism.
+ *
+ * Each entry of arguments["calls"] is {tool, arguments, id?, depends_on?}.
+ * Entries are grouped into dependency levels; a level starts only once the
+ * previous one has finished, and entries inside a level run concurrently.
+ * Results are returned in the order of the input array.
+ */
+nlohmann::json execute_batch(PwnDocClient& client, const nlohmann::json& arguments);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "client.hpp"
+#include "progress.hpp"
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Outcome of a single write issued by run_pipelined
+ */
+struct PipelineResult {
+    bool ok = false;
+    nlohmann::json response;
+    std::string error;
+};
+
+/**
+ * Aggregate timing of a run_pipelined call
+ */
+struct PipelineStats {
+    double elapsed_seconds = 0.0;
+    size_t peak_concurrency = 0;
+};
+
+/**
+ * Issue op(i) for every i in [0, count) as a pipeline of concurrent requests.
+ *
+ * Concurrency adapts between 1 and max_parallel (AIMD): it grows while
+ * requests succeed and halves on RateLimitError or TimeoutError. Results
+ * are returned in index order; exceptions are captured per item. If given,
+ * `on_done` is called (serialized) with the number of finished items.
+ */
+std::vector<PipelineResult> run_pipelined(size_t count, size_t max_parallel,
+                                          const std::function<nlohmann::json(size_t)>& op,
+                                          PipelineStats& stats,
+                                          const std::function<void(size_t done)>& on_done = nullptr);
+
+/**
+ * Fill in the ids of created findings that the server did not return.
+ * `pending` lists those requests in the order they were created, one at a
+ * time; they are paired in that order with the findings of `after` whose id
+ * is not in `known` (ids present before plus ids returned), in audit order.
+ * Nothing is paired unless both counts match, since the difference then
+ * includes findings written by someone else.
+ */
+void resolve_created_ids(const nlohmann::json& after, const std::set<std::string>& known,
+                         const std::vector<size_t>& pending, std::vector<std::string>& ids);
+
+/**
+ * Create findings in an audit with pipelined POSTs, then resolve the new
+ * finding ids and restore the requested order with a single sortFindings.
+ * When sorting against a server that does not return created ids, the
+ * findings are created one at a time so their ids can be resolved.
+ * Returns per-item status plus a summary with findings per second.
+ */
+nlohmann::json create_findings(PwnDocClient& client, const std::string& audit_id,
+                               const nlohmann::json& findings, bool sort, size_t max_parallel,
+                               const ProgressSink& progress = nullptr);
+
+/**
+ * Execute the `bulk_create_findings` tool
+ */
+nlohmann::json bulk_create_findings(PwnDocClient& client, const nlohmann::json& arguments);
+
+/**
+ * Execute the `bulk_update_findings` tool
+ */
+nlohmann::json bulk_update_findings(PwnDocClient& client, const nlohmann::json& arguments);
+
+/**
+ * Execute the `bulk_move_findings` tool: move findings to another audit
+ * with pipelined requests, then restore the order of both audits with one
+ * sortFindings each
+ */
+nlohmann::json bulk_move_findings(PwnDocClient& client, const nlohmann::json& arguments);
+
+/**
+ * Execute the `clone_audit` tool: fetch the source audit's general data,
+ * findings, sections and network in parallel, create the new audit, copy
+ * the images they reference into it, copy the metadata, then pipeline the
+ * findings and restore their order
+ */
+nlohmann::json clone_audit(PwnDocClient& client, const nlohmann::json& arguments);
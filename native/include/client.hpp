@@ -1,14 +1,24 @@
 #pragma once
 
 #include "config.hpp"
+#include "coalescer.hpp"
+#include "image_index.hpp"
+#include "job_queue.hpp"
+#include "list_pages.hpp"
+#include "object_cache.hpp"
+#include "report_cache.hpp"
+#include "result_store.hpp"
 #include <string>
 #include <nlohmann/json.hpp>
 #include <curl/curl.h>
+#include <cstdio>
 #include <optional>
 #include <deque>
 #include <chrono>
 #include <stdexcept>
 #include <map>
+#include <mutex>
+#include <vector>
 
 /**
  * Exception classes matching Python implementation
@@ -33,6 +43,11 @@ public:
     explicit NotFoundError(const std::string& message) : PwnDocError(message) {}
 };
 
+class TimeoutError : public PwnDocError {
+public:
+    explicit TimeoutError(const std::string& message) : PwnDocError(message) {}
+};
+
 /**
  * Simple sliding window rate limiter matching Python implementation
  */
@@ -56,6 +71,64 @@ private:
     std::deque<std::chrono::steady_clock::time_point> requests_;
 };
 
+/**
+ * Payload of a PwnDoc API response ({"status": ..., "datas": ...}).
+ * Responses without a "datas" member are returned unchanged.
+ */
+nlohmann::json response_datas(const nlohmann::json& response);
+
+struct DownloadSink;
+
+/**
+ * Request body sent in pieces as it is read: `head`, the contents of
+ * `file` from its start, then `tail`. The file is rewound for each attempt.
+ */
+struct UploadSource {
+    std::string head;
+    std::FILE* file = nullptr;
+    std::string tail;
+};
+
+/**
+ * File written by PwnDocClient::download
+ */
+struct DownloadResult {
+    std::string path;            // absolute path of the written file
+    size_t bytes = 0;
+    std::string content_type;
+    std::string sha256;          // empty unless requested
+};
+
+/**
+ * Scoped deadline applied to every request issued by the current thread.
+ * Requests started after the deadline fail with TimeoutError, and the CURL
+ * timeout of in-flight requests is capped to the remaining budget.
+ */
+class RequestDeadline {
+public:
+    explicit RequestDeadline(std::chrono::milliseconds budget);
+
+    /**
+     * Install a deadline captured with current() on another thread, so
+     * that worker threads keep the deadline of the call they work for.
+     * Does nothing if `deadline` is empty.
+     */
+    explicit RequestDeadline(std::optional<std::chrono::steady_clock::time_point> deadline);
+
+    ~RequestDeadline();
+
+    RequestDeadline(const RequestDeadline&) = delete;
+    RequestDeadline& operator=(const RequestDeadline&) = delete;
+
+    /**
+     * Deadline active on the current thread, if any
+     */
+    static std::optional<std::chrono::steady_clock::time_point> current();
+
+private:
+    std::optional<std::chrono::steady_clock::time_point> previous_;
+};
+
 /**
  * PwnDoc API Client with comprehensive features:
  * - Automatic authentication and token refresh
@@ -63,6 +136,10 @@ private:
  * - Automatic retries with exponential backoff
  * - Comprehensive error handling
  * - Logging
+ *
+ * The client is safe to share between threads: each request borrows a CURL
+ * handle from an internal pool, and authentication and rate limiting state
+ * are guarded by their own mutexes.
  */
 class PwnDocClient {
 public:
@@ -88,11 +165,50 @@ public:
      */
     nlohmann::json put(const std::string& endpoint, const nlohmann::json& data = {});
 
+    /**
+     * Make POST request with an already serialized JSON body
+     */
+    nlohmann::json post_raw(const std::string& endpoint, const std::string& body);
+
+    /**
+     * Make PUT request with an already serialized JSON body
+     */
+    nlohmann::json put_raw(const std::string& endpoint, const std::string& body);
+
+    /**
+     * Make PUT request with a JSON body read from `source` while it is sent,
+     * so the body is never held in memory as a whole
+     */
+    nlohmann::json put_stream(const std::string& endpoint, const UploadSource& source);
+
     /**
      * Make DELETE request with optional body
      */
     nlohmann::json del(const std::string& endpoint, const nlohmann::json& data = {});
 
+    /**
+     * PUT only the top-level fields of `data` that differ from the cached
+     * state of `endpoint`, which this client's own writes keep current.
+     * Without a cached copy the full object is sent; if nothing changed the
+     * request is skipped. No request is made to check the cached state; the
+     * result reports the fields left out and the bytes they saved.
+     */
+    nlohmann::json put_changes(const std::string& endpoint, const nlohmann::json& data);
+
+    /**
+     * Stream a binary response to disk instead of buffering and parsing it.
+     *
+     * If `path` names a directory (or ends with a separator), the file name
+     * comes from the Content-Disposition header, falling back to
+     * `fallback_name`. The body is written to a temporary file that is only
+     * renamed into place once complete. With `sha256` the digest is computed
+     * while the body streams in. A non-zero `timeout` replaces the
+     * configured request timeout, for endpoints that render before sending.
+     */
+    DownloadResult download(const std::string& endpoint, const std::string& path,
+                            bool sha256 = false, const std::string& fallback_name = "",
+                            std::chrono::seconds timeout = std::chrono::seconds(0));
+
     /**
      * Test connection
      */
@@ -103,13 +219,93 @@ public:
      */
     bool is_authenticated() const;
 
+    /**
+     * Configuration this client was created with
+     */
+    const Config& config() const { return config_; }
+
+    /**
+     * Write-behind buffer merging rapid updates to the same object
+     */
+    WriteCoalescer& write_coalescer() { return write_coalescer_; }
+
+    /**
+     * Last fetched state of individual objects, invalidated on every write
+     */
+    ObjectCache& object_cache() { return object_cache_; }
+
+    /**
+     * Digests of uploaded images, for reusing identical uploads
+     */
+    ImageIndex& image_index() { return image_index_; }
+
+    /**
+     * Background report rendering jobs
+     */
+    JobQueue& report_jobs() { return report_jobs_; }
+
+    /**
+     * Rendered reports keyed by a digest of the audit and template
+     */
+    ReportCache& report_cache() { return report_cache_; }
+
+    /**
+     * Oversized tool results served back as resources
+     */
+    ResultStore& result_store() { return result_store_; }
+
+    /**
+     * Full list responses that paginated list tools slice pages from
+     */
+    ListPages& list_pages() { return list_pages_; }
+
 private:
     Config config_;
-    CURL* curl_;
+    std::mutex handles_mutex_;
+    std::vector<CURL*> idle_handles_;
+    mutable std::recursive_mutex auth_mutex_;
     std::string token_;
     std::optional<std::string> refresh_token_;
     std::optional<std::chrono::steady_clock::time_point> token_expires_;
+    std::mutex rate_mutex_;
     RateLimiter rate_limiter_;
+    WriteCoalescer write_coalescer_;
+    ObjectCache object_cache_;
+    ImageIndex image_index_;
+    ReportCache report_cache_;
+    ResultStore result_store_;
+    ListPages list_pages_;
+    // Declared last so running jobs finish before the rest of the client is torn down
+    JobQueue report_jobs_;
+
+    /**
+     * Borrow a CURL handle from the pool (creating one if none is idle)
+     */
+    CURL* acquire_handle();
+
+    /**
+     * Return a borrowed CURL handle to the pool
+     */
+    void release_handle(CURL* curl);
+
+    /**
+     * RAII lease of a pooled CURL handle
+     */
+    class HandleLease {
+    public:
+        explicit HandleLease(PwnDocClient& client)
+            : client_(client), curl_(client.acquire_handle()) {}
+        ~HandleLease() { client_.release_handle(curl_); }
+
+        HandleLease(const HandleLease&) = delete;
+        HandleLease& operator=(const HandleLease&) = delete;
+
+        CURL* get() const { return curl_; }
+
+    private:
+        PwnDocClient& client_;
+        CURL* curl_;
+    };
 
     /**
      * Ensure we have valid authentication
@@ -140,6 +336,17 @@ private:
                            const std::string& endpoint,
                            const nlohmann::json& data = {});
 
+    /**
+     * Make HTTP request with a pre-serialized body (empty for none). With a
+     * sink, a successful response body is streamed into it instead of being
+     * parsed. With an upload, the body is read from it instead of `body`.
+     */
+    nlohmann::json request_raw(const std::string& method,
+                               const std::string& endpoint,
+                               const std::string& body,
+                               DownloadSink* sink = nullptr,
+                               const UploadSource* upload = nullptr);
+
     /**
      * Build full URL
      */
@@ -153,7 +360,7 @@ private:
     /**
      * Parse cookies from CURL handle
      */
-    std::map<std::string, std::string> get_cookies();
+    std::map<std::string, std::string> get_cookies(CURL* curl);
 
     /**
      * Log message (simple stdout logging matching Python's logger)
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Write-behind buffer that merges updates to the same key.
+ *
+ * The first update for a key opens a batch. The batch is written as soon as
+ * no other write to the key is in flight, after an optional extra `window`;
+ * updates arriving while it waits are merged into it (last writer wins per
+ * field) and the merged patch is written once. An update to an idle key is
+ * therefore written at once. Writes for the same key are serialized, so a
+ * batch never overtakes the one before it. Every caller whose update went
+ * into a batch receives that batch's result or error.
+ */
+class WriteCoalescer {
+public:
+    using WriteFn = std::function<nlohmann::json(const nlohmann::json& patch)>;
+
+    explicit WriteCoalescer(std::chrono::milliseconds window);
+
+    /**
+     * Merge `patch` into the pending write for `key` and block until the
+     * write containing it has completed
+     */
+    nlohmann::json submit(const std::string& key, const nlohmann::json& patch, const WriteFn& write);
+
+private:
+    struct Batch {
+        nlohmann::json patch;
+        size_t callers = 1;
+        bool done = false;
+        nlohmann::json result;
+        std::exception_ptr error;
+        std::condition_variable cv;
+    };
+
+    struct KeyState {
+        std::mutex serial;              // held while a batch for this key is being written
+        std::shared_ptr<Batch> open;    // batch still accepting merges
+        size_t leaders = 0;             // batches opened but not yet written
+    };
+
+    std::chrono::milliseconds window_;
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<KeyState>> keys_;
+};
@@ -25,6 +25,37 @@ struct Config {
     // Retry configuration
     int max_retries = 3;
     double retry_delay = 1.0;
+
+    // Maximum number of requests issued in parallel by batch operations
+    int max_concurrency = 8;
+
+    // Extra time (ms) an update_finding waits for more updates to merge with it.
+    // Updates queued behind an in-flight write to the same finding are merged anyway.
+    int coalesce_window_ms = 0;
+
+    // Seconds fetched objects are kept for diffing updates against (0 = off)
+    int cache_ttl = 60;
+
+    // Directory for downloaded reports, templates and images (empty = data dir)
+    std::string download_dir;
+
+    // Scope in which identical uploaded images are reused: "audit", "instance" or "off"
+    std::string image_dedup = "audit";
+
+    // Reports rendered in parallel by background jobs
+    int report_workers = 2;
+
+    // Seconds a report may take to render before the request is abandoned
+    int report_timeout = 600;
+
+    // Megabytes of rendered reports kept for unchanged audits (0 = off)
+    int report_cache_mb = 256;
+
+    // Tool results above this many KiB are written to a file and returned as a resource link (0 = off)
+    int spill_threshold_kb = 256;
+
+    // Characters of each text field kept by the summary output mode
+    int summary_text_chars = 200;
     
     /**
      * Load configuration from environment and file
@@ -45,6 +76,24 @@ struct Config {
      * Get default config file path
      */
     static std::string get_config_path();
+
+    /**
+     * Connection settings of the named target instance, on top of `base`
+     * (whose URL and credentials are dropped): the "targets" entry of the
+     * config file, overridden by PWNDOC_TARGET_<NAME>_URL, _TOKEN, _USERNAME
+     * and _PASSWORD, with NAME upper-cased and other characters as "_"
+     */
+    static Config target(const std::string& name, Config base);
+
+    /**
+     * Directory holding the config file and local state (~/.pwndoc-mcp)
+     */
+    static std::string get_data_dir();
+
+    /**
+     * Directory downloads are written to when no path is given
+     */
+    std::string get_download_dir() const;
     
     /**
      * Validate configuration
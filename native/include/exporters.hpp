@@ -0,0 +1,37 @@
+#pragma once
+
+#include "client.hpp"
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * CVSS v3.x base score of a vector string ("CVSS:3.1/AV:N/AC:L/..."), or
+ * nothing if a base metric is missing or invalid
+ */
+std::optional<double> cvss3_base_score(const std::string& vector);
+
+/**
+ * Qualitative rating of a CVSS v3 score: None, Low, Medium, High, Critical
+ */
+std::string cvss3_severity(double score);
+
+/**
+ * Plain text of an HTML fragment: tags removed, block elements turned into
+ * line breaks, common entities decoded and whitespace collapsed
+ */
+std::string strip_html(const std::string& html);
+
+/**
+ * CWE identifiers ("CWE-79") mentioned in a JSON value, including links to
+ * cwe.mitre.org definitions, in order of first appearance
+ */
+std::vector<std::string> find_cwes(const nlohmann::json& value);
+
+/**
+ * Execute the `export_findings` tool: fetch audits with bounded
+ * parallelism and write their findings to a file as NDJSON, one finding
+ * per line, optionally enriched with plain text, CWE ids and severity
+ */
+nlohmann::json export_findings(PwnDocClient& client, const nlohmann::json& arguments);
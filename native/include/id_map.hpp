@@ -0,0 +1,42 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Whether a string has the form of a MongoDB ObjectId (24 hex digits)
+ */
+bool is_object_id(const std::string& id);
+
+/**
+ * Ids of images referenced as <img src="ID"> anywhere in a JSON value
+ */
+void collect_image_ids(const nlohmann::json& value, std::set<std::string>& ids);
+
+/**
+ * Old-to-new ObjectId table for copies of PwnDoc data, shared by workers
+ */
+class IdMap {
+public:
+    void put(const std::string& old_id, const std::string& new_id);
+
+    /**
+     * New id of `old_id`, or an empty string if it is not mapped
+     */
+    std::string get(const std::string& old_id) const;
+
+    size_t size() const;
+
+    /**
+     * Rewrite every known id in a value: strings equal to an old id, and
+     * image ids in <img src="ID"> inside HTML fields
+     */
+    void remap(nlohmann::json& value) const;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::string> ids_;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+/**
+ * Content-addressed index of uploaded images.
+ *
+ * Maps the SHA-256 of an image's bytes to the PwnDoc id it was uploaded
+ * under, so identical screenshots and logos are uploaded once. Entries
+ * belong to the PwnDoc instance (its URL) they were uploaded to, are scoped
+ * to their audit or shared across the instance, and are persisted as JSON
+ * so they survive restarts. An empty path keeps the index in memory.
+ */
+class ImageIndex {
+public:
+    enum class Scope { Off, Audit, Instance };
+
+    ImageIndex(std::string path, std::string instance, Scope scope);
+
+    /**
+     * Parse a scope name ("audit", "instance" or "off")
+     */
+    static Scope parse_scope(const std::string& name);
+
+    bool enabled() const { return scope_ != Scope::Off; }
+
+    /**
+     * Id of an image with this digest usable in `audit_id`
+     */
+    std::optional<std::string> find(const std::string& audit_id, const std::string& sha256);
+
+    /**
+     * Record an uploaded image
+     */
+    void store(const std::string& audit_id, const std::string& sha256, const std::string& image_id);
+
+    /**
+     * Forget a deleted image
+     */
+    void remove_image(const std::string& image_id);
+
+    /**
+     * Forget every image uploaded to a deleted audit
+     */
+    void remove_audit(const std::string& audit_id);
+
+private:
+    struct Entry {
+        std::string image_id;
+        std::string audit_id;
+    };
+
+    std::string path_;
+    std::string instance_;
+    Scope scope_;
+    std::mutex mutex_;
+    bool loaded_ = false;
+    std::map<std::string, Entry> entries_;   // "<instance> <scope>:<sha256>" -> entry
+
+    std::string key(const std::string& audit_id, const std::string& sha256) const;
+    bool own(const std::string& key) const;
+    void load();
+    void save();
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "client.hpp"
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <istream>
+
+/**
+ * Options controlling which Nmap results end up in the audit scope
+ */
+struct NmapImportOptions {
+    bool include_closed = false;   // keep ports whose state is not "open"
+    bool include_down = false;     // keep hosts whose status is not "up"
+};
+
+/**
+ * Counters collected while reading an Nmap scan
+ */
+struct NmapImportStats {
+    size_t hosts = 0;
+    size_t services = 0;
+    size_t hosts_skipped = 0;
+    size_t ports_skipped = 0;
+    size_t bytes_read = 0;
+};
+
+/**
+ * Stream-parse an Nmap XML report, passing each host to `on_host` in PwnDoc
+ * network form ({hostname, ip, os, services: [{port, protocol, name,
+ * product, version}]}). Only one <host> element is held in memory at a time.
+ */
+void read_nmap_hosts(std::istream& in, const NmapImportOptions& options,
+                     const std::function<void(const nlohmann::json& host)>& on_host,
+                     NmapImportStats& stats);
+
+/**
+ * Execute the `import_nmap` tool: parse the scan from disk and store it as a
+ * named scope of the audit network, replacing a scope of the same name
+ */
+nlohmann::json import_nmap(PwnDocClient& client, const nlohmann::json& arguments);
+
+/**
+ * Execute the `import_scanner_report` tool: stream-parse a Nessus (.nessus)
+ * or Burp XML export, group issues by plugin / issue type, match each group
+ * to a vulnerability template by title and create one finding per group
+ */
+nlohmann::json import_scanner_report(PwnDocClient& client, const nlohmann::json& arguments);
+
+/**
+ * Execute the `import_vulnerabilities` tool: stream vulnerability templates
+ * from a CSV or NDJSON file, validate them, and create new titles in batched
+ * POSTs or update existing ones, with concurrent requests per chunk of rows
+ */
+nlohmann::json import_vulnerabilities(PwnDocClient& client, const nlohmann::json& arguments);
+
+/**
+ * Execute the `sync_vulnerabilities` tool: replicate the vulnerability
+ * templates of this instance to a target instance. Templates are matched by
+ * title, compared by a content hash per locale, and only the differences
+ * are written, as concurrent batches of creates, updates and deletes.
+ * Target templates missing from the source are deleted only with
+ * `delete_missing`, and listed otherwise.
+ */
+nlohmann::json sync_vulnerabilities(PwnDocClient& client, const nlohmann::json& arguments);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Background jobs run by a bounded pool of worker threads.
+ *
+ * submit() returns a job id at once; the work runs on the first free worker
+ * and its result or error is kept for polling. Workers are started on first
+ * use. Finished jobs are kept up to a limit, oldest dropped first.
+ */
+class JobQueue {
+public:
+    using Work = std::function<nlohmann::json()>;
+
+    explicit JobQueue(size_t workers, size_t max_finished = 100);
+    ~JobQueue();
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    /**
+     * Queue `work` and return its job id. While a job with the same
+     * non-empty `key` is queued or running, its id is returned instead.
+     * `info` is echoed in the job's status.
+     */
+    std::string submit(const std::string& key, const nlohmann::json& info, Work work);
+
+    /**
+     * Status of a job ({job_id, status, ..., result | error}), or nullopt
+     * for an unknown id
+     */
+    std::optional<nlohmann::json> status(const std::string& id);
+
+    /**
+     * Status of every known job, oldest first
+     */
+    nlohmann::json list();
+
+private:
+    enum class State { Queued, Running, Completed, Failed };
+
+    struct Job {
+        std::string id;
+        std::string key;
+        nlohmann::json info;
+        Work work;
+        State state = State::Queued;
+        std::chrono::steady_clock::time_point queued;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point finished;
+        nlohmann::json result;
+        std::string error;
+    };
+
+    size_t workers_;
+    size_t max_finished_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    size_t next_id_ = 1;
+    std::vector<std::thread> threads_;
+    std::deque<std::shared_ptr<Job>> pending_;
+    std::map<std::string, std::shared_ptr<Job>> jobs_;
+    std::deque<std::string> finished_order_;
+
+    void run_worker();
+    nlohmann::json describe(const Job& job) const;
+};
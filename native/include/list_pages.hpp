@@ -0,0 +1,46 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Full responses of list tools, kept so that later pages are sliced from
+ * memory instead of being fetched again.
+ *
+ * Each stored list gets a random id that pagination cursors refer to.
+ * Lists expire `ttl` after they were last read, and the least recently
+ * read lists are evicted beyond `max_lists`.
+ */
+class ListPages {
+public:
+    ListPages(std::chrono::seconds ttl, size_t max_lists = 16);
+
+    /**
+     * Keep the response of `tool`; returns the id cursors refer to
+     */
+    std::string store(const std::string& tool, nlohmann::json response);
+
+    /**
+     * Response stored under `id` by `tool`, or null if unknown or expired
+     */
+    std::shared_ptr<const nlohmann::json> find(const std::string& id, const std::string& tool);
+
+private:
+    struct Entry {
+        std::string tool;
+        std::shared_ptr<const nlohmann::json> response;
+        std::chrono::steady_clock::time_point used;
+        std::list<std::string>::iterator lru;
+    };
+
+    std::chrono::seconds ttl_;
+    size_t max_lists_;
+    std::mutex mutex_;
+    std::list<std::string> lru_;
+    std::unordered_map<std::string, Entry> entries_;
+};
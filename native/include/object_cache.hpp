@@ -0,0 +1,51 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Last known server state of individual objects, keyed by API endpoint.
+ *
+ * Entries expire after `ttl` and the least recently used entries are evicted
+ * beyond `max_entries`. A ttl of zero disables the cache entirely.
+ */
+class ObjectCache {
+public:
+    ObjectCache(std::chrono::seconds ttl, size_t max_entries = 1024);
+
+    /**
+     * Remember the current state of the object at `key`
+     */
+    void store(const std::string& key, const nlohmann::json& object);
+
+    /**
+     * Cached state of the object at `key`, if present and not expired
+     */
+    std::optional<nlohmann::json> find(const std::string& key);
+
+    /**
+     * Drop every entry whose key is a prefix of `endpoint` or starts with it.
+     * Called for every write so that cached state never outlives a change.
+     */
+    void invalidate(const std::string& endpoint);
+
+    bool enabled() const { return ttl_.count() > 0; }
+
+private:
+    struct Entry {
+        nlohmann::json object;
+        std::chrono::steady_clock::time_point stored;
+        std::list<std::string>::iterator lru;
+    };
+
+    std::chrono::seconds ttl_;
+    size_t max_entries_;
+    std::mutex mutex_;
+    std::list<std::string> lru_;
+    std::unordered_map<std::string, Entry> entries_;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+
+/**
+ * Run task(i) for every i in [0, count) on at most max_workers threads.
+ *
+ * Indices are handed out in ascending order, so with max_workers == 1 this
+ * degrades to a plain sequential loop on the calling thread. If a task
+ * throws, no further indices are started and the first exception is
+ * rethrown once all running tasks have finished. Worker threads inherit
+ * the calling thread's RequestDeadline.
+ */
+void parallel_for(size_t count, size_t max_workers, const std::function<void(size_t)>& task);
+
+/**
+ * AIMD concurrency limit for pipelined writes.
+ *
+ * The limit starts low, grows additively (roughly one slot per round of
+ * successful requests) up to max_limit, and halves whenever a request
+ * reports that the server is overloaded (rate limited or timed out).
+ */
+class AdaptiveLimiter {
+public:
+    AdaptiveLimiter(size_t initial_limit, size_t max_limit);
+
+    /**
+     * Block until a slot is available under the current limit
+     */
+    void acquire();
+
+    /**
+     * Release a slot and adjust the limit based on the request outcome
+     */
+    void release(bool overloaded);
+
+    /**
+     * Current and highest observed concurrency limit
+     */
+    size_t limit() const;
+    size_t peak() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    double limit_;
+    size_t max_limit_;
+    size_t in_flight_ = 0;
+    size_t peak_;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+/**
+ * Receives progress updates of a long-running tool call.
+ * `total` is zero when the amount of work is not known.
+ */
+using ProgressSink = std::function<void(double progress, double total, const std::string& message)>;
+
+/**
+ * Scoped progress sink for tool calls running on the current thread. The
+ * server installs one when the client asked for progress notifications;
+ * otherwise reports are dropped. Sinks may be called from any thread.
+ */
+class ProgressScope {
+public:
+    explicit ProgressScope(ProgressSink sink);
+    ~ProgressScope();
+
+    ProgressScope(const ProgressScope&) = delete;
+    ProgressScope& operator=(const ProgressScope&) = delete;
+
+    /**
+     * Sink active on the current thread; reports to it are discarded if none
+     * is installed. Copy it to report from worker threads.
+     */
+    static ProgressSink current();
+
+private:
+    ProgressSink previous_;
+};
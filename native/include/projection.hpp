@@ -0,0 +1,62 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Set of field paths to keep from an API response.
+ *
+ * Paths are dotted ("client.name") or JSON pointers ("/client/name") and
+ * are applied to the `datas` of the response. Arrays are passed through,
+ * so a path names object keys only and applies to every element. A path
+ * keeps the whole subtree below it.
+ */
+class FieldProjection {
+public:
+    /**
+     * Build from an array of paths or a comma-separated string
+     */
+    explicit FieldProjection(const nlohmann::json& fields);
+
+    bool empty() const { return root_.children.empty(); }
+
+    /**
+     * Parser callback dropping every key outside the projection while the
+     * response is parsed, so unselected subtrees are never materialized.
+     * Each call returns a callback with fresh state, for one parse.
+     */
+    nlohmann::json::parser_callback_t callback() const;
+
+private:
+    struct Node {
+        std::map<std::string, Node> children;
+        bool keep = false;   // keep the whole subtree
+    };
+
+    Node root_;
+
+    void add(const std::vector<std::string>& path);
+};
+
+/**
+ * Scoped projection applied to JSON responses received by the current
+ * thread
+ */
+class ProjectionScope {
+public:
+    explicit ProjectionScope(const FieldProjection& projection);
+    ~ProjectionScope();
+
+    ProjectionScope(const ProjectionScope&) = delete;
+    ProjectionScope& operator=(const ProjectionScope&) = delete;
+
+    /**
+     * Projection active on the current thread, or null
+     */
+    static const FieldProjection* current();
+
+private:
+    const FieldProjection* previous_;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+/**
+ * On-disk cache of rendered reports keyed by a digest of their inputs.
+ *
+ * Each entry is a directory named after the key holding the report under
+ * its original file name. Hits refresh the entry's modification time, and
+ * after every store the least recently used entries are removed until the
+ * cache fits in `max_bytes`. A limit of 0 disables the cache.
+ */
+class ReportCache {
+public:
+    ReportCache(std::string directory, uint64_t max_bytes);
+
+    bool enabled() const { return max_bytes_ > 0 && !directory_.empty(); }
+
+    /**
+     * Path of the cached report for `key`, if present
+     */
+    std::optional<std::string> find(const std::string& key);
+
+    /**
+     * Copy a freshly rendered report into the cache under `key`
+     */
+    void store(const std::string& key, const std::string& path);
+
+    /**
+     * Remove every cached report. Keys do not cover a template's file, so
+     * the cache is cleared whenever a template is replaced or deleted.
+     */
+    void clear();
+
+private:
+    std::string directory_;
+    uint64_t max_bytes_;
+    std::mutex mutex_;
+
+    void evict();
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Tool results too large to return inline, kept on disk and served back
+ * as MCP resources (pwndoc://results/ID) in byte ranges.
+ *
+ * Only the most recent `max_results` results are kept; older files are
+ * removed whenever a new result is stored. The directory is private to the
+ * user (0700, files 0600), and the results stored by this process are
+ * removed when it is destroyed. A threshold of 0 disables spilling.
+ */
+class ResultStore {
+public:
+    static constexpr const char* URI_PREFIX = "pwndoc://results/";
+
+    ResultStore(std::string directory, uint64_t threshold_bytes, size_t max_results = 50);
+    ~ResultStore();
+
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    bool enabled() const { return threshold_bytes_ > 0 && !directory_.empty(); }
+
+    /**
+     * Whether a serialized result of this size should be spilled
+     */
+    bool should_spill(uint64_t bytes) const { return enabled() && bytes > threshold_bytes_; }
+
+    /**
+     * Write `text` to a new result file; returns {uri, name, path, size}
+     */
+    nlohmann::json store(const std::string& name, const std::string& text);
+
+    /**
+     * Read `length` bytes of a stored result from `offset`. The end of the
+     * range is moved back to a UTF-8 character boundary. Returns {uri,
+     * text, offset, length, total_bytes, next_offset} where next_offset is
+     * null once the end is reached.
+     */
+    nlohmann::json read(const std::string& uri, uint64_t offset, uint64_t length) const;
+
+    /**
+     * Stored results as MCP resource descriptors, newest first
+     */
+    nlohmann::json list() const;
+
+private:
+    std::string directory_;
+    uint64_t threshold_bytes_;
+    size_t max_results_;
+    std::atomic<uint64_t> counter_{0};
+    mutable std::mutex mutex_;
+    std::vector<std::string> stored_;   // files written by this process
+
+    std::string path_for(const std::string& uri) const;
+    void evict();
+};
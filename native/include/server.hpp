@@ -5,6 +5,12 @@
 #include <string>
 #include <functional>
 #include <map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <vector>
 
 /**
  * MCP Server implementation
@@ -22,6 +28,16 @@ public:
 private:
     Config config_;
     std::unique_ptr<PwnDocClient> client_;
+    std::mutex output_mutex_;
+    // tools/call requests waiting for a worker, and the workers serving them
+    std::mutex workers_mutex_;
+    std::condition_variable workers_cv_;
+    std::deque<std::string> calls_;
+    std::vector<std::thread> workers_;
+    size_t idle_workers_ = 0;
+    bool stopping_ = false;
+    // Client understands resource_link content (MCP 2025-06-18 and later)
+    std::atomic<bool> resource_links_{false};
     
     /**
      * Handle incoming JSON-RPC request
@@ -37,7 +53,37 @@ private:
      * Handle tools/call request
      */
     std::string handle_call_tool(const std::string& name, const nlohmann::json& arguments);
+
+    /**
+     * Write an oversized result to the result store and build the tool
+     * response pointing at it: a short summary of the result's shape plus
+     * a resource link when the client supports one
+     */
+    nlohmann::json spill_result(const std::string& name, const nlohmann::json& result, const std::string& text);
+
+    /**
+     * Handle resources/read: a byte range of a spilled result
+     */
+    nlohmann::json handle_read_resource(const nlohmann::json& params);
     
+    /**
+     * Queue a tools/call request for the worker pool so that a slow tool
+     * does not hold up the requests queued behind it. Responses carry the
+     * request id, so they may be written out of order. Blocks while
+     * PWNDOC_MAX_CONCURRENCY calls are already waiting.
+     */
+    void dispatch_async(const std::string& request);
+
+    /**
+     * Worker loop: handle queued tools/call requests until stopped
+     */
+    void run_worker();
+
+    /**
+     * Let the workers finish every queued call, then join them
+     */
+    void stop_workers();
+
     /**
      * Read a line from stdin
      */
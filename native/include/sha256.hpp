@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Incremental SHA-256 (FIPS 180-4), used to fingerprint downloaded and
+ * uploaded files without holding them in memory
+ */
+class Sha256 {
+public:
+    Sha256();
+
+    /**
+     * Hash `size` more bytes
+     */
+    void update(const void* data, size_t size);
+
+    /**
+     * Finish hashing and return the digest as 64 lowercase hex digits.
+     * The object is reset afterwards.
+     */
+    std::string hex_digest();
+
+    /**
+     * Start over with an empty message
+     */
+    void reset();
+
+    /**
+     * Hex digest of a complete buffer
+     */
+    static std::string hash(const void* data, size_t size);
+
+    /**
+     * Hex digest of a file, read in chunks
+     */
+    static std::string hash_file(const std::string& path);
+
+private:
+    uint32_t state_[8];
+    uint8_t block_[64];
+    size_t block_size_ = 0;
+    uint64_t length_ = 0;
+
+    void transform(const uint8_t* block);
+};
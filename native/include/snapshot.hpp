@@ -0,0 +1,101 @@
+#pragma once
+
+#include "client.hpp"
+#include "sha256.hpp"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+struct gzFile_s;
+
+/**
+ * Writer for snapshot archives: gzip-compressed NDJSON, one record per line.
+ *
+ * Records are {"type": ..., "data": ...} plus optional context fields. The
+ * writer is shared by fetch workers; each record is compressed as soon as it
+ * is written, so memory does not grow with the size of the instance. Counts
+ * and a SHA-256 over the serialized data of each record type are kept for
+ * the manifest written by close().
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(const std::string& path);
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    /**
+     * Append a record. `data` is already serialized JSON; `context` holds
+     * any extra top-level fields.
+     */
+    void write(const std::string& type, const std::string& data,
+               const nlohmann::json& context = nlohmann::json::object());
+
+    /**
+     * Append the manifest (with `extra` merged in) and finish the archive.
+     * Returns the manifest.
+     */
+    nlohmann::json close(const nlohmann::json& extra);
+
+    uint64_t records() const { return records_; }
+
+private:
+    std::string path_;
+    gzFile_s* file_;
+    std::mutex mutex_;
+    std::map<std::string, size_t> counts_;
+    std::map<std::string, Sha256> checksums_;
+    uint64_t records_ = 0;
+    uint64_t bytes_ = 0;
+
+    void write_line(const std::string& line);
+};
+
+/**
+ * Line reader for snapshot archives (gzip or plain NDJSON)
+ */
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string& path);
+    ~SnapshotReader();
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    /**
+     * Read the next line into `line`; false at end of input
+     */
+    bool next(std::string& line);
+
+    /**
+     * Uncompressed bytes consumed so far
+     */
+    uint64_t bytes_read() const { return bytes_read_; }
+
+private:
+    gzFile_s* file_;
+    std::string buffer_;
+    size_t pos_ = 0;
+    bool eof_ = false;
+    uint64_t bytes_read_ = 0;
+};
+
+/**
+ * Execute the `snapshot` tool: back up every entity the tools cover
+ * (reference data, settings, templates, clients, companies, vulnerabilities,
+ * audits with their findings, and the images they reference) into a
+ * compressed NDJSON archive, fetching with bounded parallelism
+ */
+nlohmann::json snapshot(PwnDocClient& client, const nlohmann::json& arguments);
+
+/**
+ * Execute the `restore` tool: verify a snapshot archive, then stream it
+ * once per dependency level (reference data; audit types, clients,
+ * companies and vulnerabilities; audits; images; audit contents and
+ * findings), creating each level with pipelined requests and rewriting
+ * references through an old-to-new id table
+ */
+nlohmann::json restore(PwnDocClient& client, const nlohmann::json& arguments);
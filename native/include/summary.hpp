@@ -0,0 +1,32 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <string>
+
+/**
+ * Limits applied by the summary output mode
+ */
+struct SummaryOptions {
+    size_t max_text = 200;     // characters kept of each text field
+    size_t list_depth = 1;     // arrays nested deeper are replaced by their size
+};
+
+/**
+ * Compact form of a text field: base64 blobs and data URIs become their
+ * decoded size, HTML becomes plain text, and text longer than `max_text`
+ * characters is cut with a marker giving the number of characters dropped
+ */
+std::string summarize_text(const std::string& text, size_t max_text);
+
+/**
+ * Compact form of a response's data for reading by a model. Arrays at
+ * depth 0 to `list_depth` are listed; deeper non-empty arrays are replaced
+ * by "[N items]". Every string goes through summarize_text.
+ */
+nlohmann::json summarize(const nlohmann::json& value, const SummaryOptions& options);
+
+/**
+ * Summarize the `datas` of an API response (or the response itself) and
+ * add a `summary` object reporting the serialized size before and after
+ */
+nlohmann::json summarize_response(const nlohmann::json& response, const SummaryOptions& options);
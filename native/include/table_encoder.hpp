@@ -0,0 +1,27 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * Columns of a list of objects: their keys in order of first appearance,
+ * plus "value" when the list also holds non-object items
+ */
+std::vector<std::string> table_columns(const nlohmann::json& items);
+
+/**
+ * Append a list response to `out` as compact JSON with the column names
+ * given once: {<other response fields>, "columns": [...], "rows": [[...]]}.
+ * Rows are written one at a time from the parsed items; missing cells are
+ * null and nested values are kept as JSON.
+ */
+void encode_table(const nlohmann::json& response, std::string& out);
+
+/**
+ * Append a list response to `out` as tab-separated values: other response
+ * fields as "# key: value" lines, a header line, then one line per item.
+ * Tabs, line breaks and backslashes in text are escaped, null cells are
+ * empty and nested values are written as JSON.
+ */
+void encode_tsv(const nlohmann::json& response, std::string& out);
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+class XmlParseError : public std::runtime_error {
+public:
+    explicit XmlParseError(const std::string& message) : std::runtime_error(message) {}
+};
+
+/**
+ * Pull parser for large XML documents.
+ *
+ * Input is read through a fixed-size buffer and only the current tag, its
+ * attributes and the current text run are held in memory, so scanner
+ * exports of any size can be processed in constant memory. Entities and
+ * CDATA sections are decoded; comments, processing instructions and
+ * DOCTYPE declarations are skipped. Self-closing tags produce a
+ * StartElement immediately followed by an EndElement.
+ */
+class XmlReader {
+public:
+    enum class Event { StartElement, EndElement, Text, EndDocument };
+
+    explicit XmlReader(std::istream& in, size_t buffer_size = 64 * 1024);
+
+    /**
+     * Advance to the next event
+     */
+    Event next();
+
+    /**
+     * Name of the element just started or ended
+     */
+    const std::string& name() const { return name_; }
+
+    /**
+     * Decoded content of the last Text event
+     */
+    const std::string& text() const { return text_; }
+
+    /**
+     * Attribute of the element just started, or `fallback` if absent
+     */
+    std::string attribute(const std::string& key, const std::string& fallback = "") const;
+
+    /**
+     * Number of open elements, including one just started
+     */
+    size_t depth() const { return stack_.size(); }
+
+    /**
+     * Bytes consumed from the input so far
+     */
+    size_t bytes_read() const { return consumed_ + pos_; }
+
+    /**
+     * Concatenated text inside the element just started, consuming it up to
+     * and including its end tag
+     */
+    std::string read_text();
+
+    /**
+     * Consume the rest of the element just started, including its end tag
+     */
+    void skip_element();
+
+private:
+    std::istream& in_;
+    std::vector<char> buffer_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    size_t consumed_ = 0;
+    size_t line_ = 1;
+
+    std::string name_;
+    std::string text_;
+    std::vector<std::pair<std::string, std::string>> attributes_;
+    std::vector<std::string> stack_;
+    bool pending_end_ = false;
+
+    bool fill();
+    int peek();
+    int get();
+    void expect(char c);
+    void skip_whitespace();
+    void skip_past(const std::string& terminator);
+    std::string read_name();
+    void read_entity(std::string& out);
+    [[noreturn]] void fail(const std::string& message) const;
+};
@@ -0,0 +1,322 @@
+#include "base64.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PWNDOC_BASE64_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 0-63 for alphabet characters, 64 for '=', 255 for anything else
+struct DecodeTable {
+    uint8_t values[256];
+
+    DecodeTable() {
+        for (auto& value : values) value = 255;
+        for (int i = 0; i < 64; ++i) values[static_cast<uint8_t>(ALPHABET[i])] = static_cast<uint8_t>(i);
+        values[static_cast<uint8_t>('=')] = 64;
+    }
+};
+
+const DecodeTable DECODE;
+
+// File chunk size; a multiple of 3 so chunks encode without padding
+constexpr size_t FILE_CHUNK = 3 * 64 * 1024;
+
+size_t encode_scalar(const uint8_t* data, size_t size, char* out) {
+    char* start = out;
+    size_t i = 0;
+    for (; i + 3 <= size; i += 3) {
+        uint32_t triple = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+        *out++ = ALPHABET[(triple >> 18) & 0x3F];
+        *out++ = ALPHABET[(triple >> 12) & 0x3F];
+        *out++ = ALPHABET[(triple >> 6) & 0x3F];
+        *out++ = ALPHABET[triple & 0x3F];
+    }
+
+    size_t rest = size - i;
+    if (rest > 0) {
+        uint32_t triple = uint32_t(data[i]) << 16;
+        if (rest == 2) triple |= uint32_t(data[i + 1]) << 8;
+        *out++ = ALPHABET[(triple >> 18) & 0x3F];
+        *out++ = ALPHABET[(triple >> 12) & 0x3F];
+        *out++ = rest == 2 ? ALPHABET[(triple >> 6) & 0x3F] : '=';
+        *out++ = '=';
+    }
+    return static_cast<size_t>(out - start);
+}
+
+// Decodes unpadded input; returns false at the first character outside the
+// alphabet, leaving its offset in `bad`
+bool decode_scalar(const char* text, size_t size, uint8_t* out, size_t& written, size_t& bad) {
+    uint8_t* start = out;
+    uint32_t accumulator = 0;
+    int bits = 0;
+    for (size_t i = 0; i < size; ++i) {
+        uint8_t value = DECODE.values[static_cast<uint8_t>(text[i])];
+        if (value >= 64) {
+            bad = i;
+            return false;
+        }
+        accumulator = (accumulator << 6) | value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            *out++ = static_cast<uint8_t>(accumulator >> bits);
+        }
+    }
+    written = static_cast<size_t>(out - start);
+    return true;
+}
+
+#ifdef PWNDOC_BASE64_X86
+
+// The vector kernels follow Mula and Lemire, "Faster Base64 Encoding and
+// Decoding using AVX2 Instructions". Each handles whole blocks and returns
+// how far it got; the scalar code finishes the tail. The same steps run on
+// 16-byte (SSSE3) or two 16-byte lanes (AVX2) at a time.
+
+// 12 input bytes per 16-byte lane -> 16 alphabet indices
+__attribute__((target("ssse3")))
+__m128i encode_indices_sse(__m128i in) {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+// Alphabet indices -> ASCII, by adding a per-range offset
+__attribute__((target("ssse3")))
+__m128i encode_ascii_sse(__m128i indices) {
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                          '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range));
+}
+
+__attribute__((target("ssse3")))
+size_t encode_ssse3(const uint8_t* data, size_t size, char* out) {
+    size_t i = 0;
+    // Loads 16 bytes but consumes 12
+    for (; i + 16 <= size; i += 12) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encode_ascii_sse(encode_indices_sse(in)));
+        out += 16;
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+size_t encode_avx2(const uint8_t* data, size_t size, char* out) {
+    const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                            10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i offsets = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+    size_t i = 0;
+    // Each lane takes 12 of the 24 bytes consumed; the upper load reads 4 past them
+    for (; i + 28 <= size; i += 24) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        in = _mm256_shuffle_epi8(in, shuffle);
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+        __m256i ascii = _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), ascii);
+        out += 32;
+    }
+    return i;
+}
+
+// Lookup tables for decoding: a character is invalid when the entries for
+// its low and high nibbles share a bit; `roll` maps the high nibble (or '/')
+// to the offset from ASCII to the 6-bit value
+#define PWNDOC_BASE64_DECODE_LO 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, \
+                                0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+#define PWNDOC_BASE64_DECODE_HI 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, \
+                                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+#define PWNDOC_BASE64_DECODE_ROLL 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+
+__attribute__((target("ssse3")))
+size_t decode_ssse3(const char* text, size_t size, uint8_t* out) {
+    const __m128i lut_lo = _mm_setr_epi8(PWNDOC_BASE64_DECODE_LO);
+    const __m128i lut_hi = _mm_setr_epi8(PWNDOC_BASE64_DECODE_HI);
+    const __m128i lut_roll = _mm_setr_epi8(PWNDOC_BASE64_DECODE_ROLL);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+
+    size_t i = 0;
+    // Stores 16 bytes but produces 12; the 8 characters held back leave room
+    for (; i + 24 <= size; i += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), nibble);
+        __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(in, nibble));
+        __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0) break;
+
+        __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+        __m128i values = _mm_add_epi8(in, _mm_shuffle_epi8(lut_roll, _mm_add_epi8(slash, hi_nibbles)));
+
+        __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i packed = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        packed = _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+        out += 12;
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+size_t decode_avx2(const char* text, size_t size, uint8_t* out) {
+    const __m256i lut_lo = _mm256_setr_epi8(PWNDOC_BASE64_DECODE_LO, PWNDOC_BASE64_DECODE_LO);
+    const __m256i lut_hi = _mm256_setr_epi8(PWNDOC_BASE64_DECODE_HI, PWNDOC_BASE64_DECODE_HI);
+    const __m256i lut_roll = _mm256_setr_epi8(PWNDOC_BASE64_DECODE_ROLL, PWNDOC_BASE64_DECODE_ROLL);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+
+    size_t i = 0;
+    // Stores 32 bytes but produces 24; the 12 characters held back leave room
+    for (; i + 44 <= size; i += 32) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), nibble);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(in, nibble));
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        if (!_mm256_testz_si256(lo, hi)) break;
+
+        __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+        __m256i values = _mm256_add_epi8(in, _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(slash, hi_nibbles)));
+
+        __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i packed = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        packed = _mm256_shuffle_epi8(packed, _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+        out += 24;
+    }
+    return i;
+}
+
+#endif // PWNDOC_BASE64_X86
+
+// Vector kernels for the running CPU, chosen once. A kernel returns the
+// number of input bytes it handled in whole blocks.
+struct Kernels {
+    size_t (*encode)(const uint8_t*, size_t, char*) = nullptr;
+    size_t (*decode)(const char*, size_t, uint8_t*) = nullptr;
+    const char* name = "scalar";
+
+    Kernels() {
+#ifdef PWNDOC_BASE64_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            encode = encode_avx2;
+            decode = decode_avx2;
+            name = "avx2";
+        } else if (__builtin_cpu_supports("ssse3")) {
+            encode = encode_ssse3;
+            decode = decode_ssse3;
+            name = "ssse3";
+        }
+#endif
+    }
+};
+
+const Kernels& kernels() {
+    static const Kernels instance;
+    return instance;
+}
+
+} // namespace
+
+size_t base64_encoded_size(size_t size) {
+    return (size + 2) / 3 * 4;
+}
+
+const char* base64_backend() {
+    return kernels().name;
+}
+
+size_t base64_encode(const uint8_t* data, size_t size, char* out) {
+    size_t done = 0;
+    if (kernels().encode) done = kernels().encode(data, size, out);
+    return done / 3 * 4 + encode_scalar(data + done, size - done, out + done / 3 * 4);
+}
+
+std::string base64_encode(const std::string& data) {
+    std::string out(base64_encoded_size(data.size()), '\0');
+    base64_encode(reinterpret_cast<const uint8_t*>(data.data()), data.size(), &out[0]);
+    return out;
+}
+
+size_t base64_decode(const char* text, size_t size, uint8_t* out) {
+    // Padding only ever appears at the end
+    while (size > 0 && text[size - 1] == '=') --size;
+
+    // A kernel stops early at an invalid block; the scalar pass then
+    // reports the exact offset
+    size_t done = 0;
+    if (kernels().decode) done = kernels().decode(text, size, out);
+
+    size_t written = 0;
+    size_t bad = 0;
+    if (!decode_scalar(text + done, size - done, out + done / 4 * 3, written, bad)) {
+        throw std::invalid_argument("Invalid base64 character at offset " + std::to_string(done + bad));
+    }
+    return done / 4 * 3 + written;
+}
+
+std::string base64_decode(const std::string& text) {
+    std::string out(text.size() / 4 * 3 + 3, '\0');
+    size_t written = base64_decode(text.data(), text.size(), reinterpret_cast<uint8_t*>(&out[0]));
+    out.resize(written);
+    return out;
+}
+
+size_t base64_append_file(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    size_t size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    size_t offset = out.size();
+    out.resize(offset + base64_encoded_size(size));
+
+    std::vector<uint8_t> chunk(FILE_CHUNK);
+    size_t total = 0;
+    while (total < size) {
+        file.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        size_t got = static_cast<size_t>(file.gcount());
+        if (got == 0) break;
+        offset += base64_encode(chunk.data(), got, &out[offset]);
+        total += got;
+    }
+    if (total != size) {
+        throw std::runtime_error("File changed while reading: " + path);
+    }
+    return total;
+}
@@ -0,0 +1,187 @@
+#include "batch.hpp"
+#include "parallel.hpp"
+#include "tools.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+struct BatchEntry {
+    std::string tool;
+    json arguments;
+    std::string id;
+    std::vector<size_t> depends_on;
+    int level = -1;
+};
+
+long long elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Assign each entry its dependency depth (0 = no dependencies)
+int assign_level(std::vector<BatchEntry>& entries, size_t index, std::vector<bool>& visiting) {
+    BatchEntry& entry = entries[index];
+    if (entry.level >= 0) return entry.level;
+    if (visiting[index]) {
+        throw std::runtime_error("Dependency cycle involving batch entry " + std::to_string(index));
+    }
+
+    visiting[index] = true;
+    int level = 0;
+    for (size_t dep : entry.depends_on) {
+        level = std::max(level, assign_level(entries, dep, visiting) + 1);
+    }
+    visiting[index] = false;
+
+    entry.level = level;
+    return level;
+}
+
+std::vector<BatchEntry> parse_entries(const json& calls) {
+    std::vector<BatchEntry> entries;
+    std::map<std::string, size_t> ids;
+
+    for (size_t i = 0; i < calls.size(); ++i) {
+        const json& call = calls[i];
+        if (!call.is_object() || !call.contains("tool") || !call["tool"].is_string()) {
+            throw std::runtime_error("Batch entry " + std::to_string(i) + " must be an object with a 'tool' name");
+        }
+
+        BatchEntry entry;
+        entry.tool = call["tool"].get<std::string>();
+        entry.arguments = call.value("arguments", json::object());
+        if (entry.tool == "batch") {
+            throw std::runtime_error("Batch entry " + std::to_string(i) + " cannot be a nested batch");
+        }
+
+        if (call.contains("id")) {
+            entry.id = call["id"].get<std::string>();
+            if (!ids.emplace(entry.id, i).second) {
+                throw std::runtime_error("Duplicate batch entry id: " + entry.id);
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    // Resolve dependencies once every id is known so forward references work
+    for (size_t i = 0; i < calls.size(); ++i) {
+        if (!calls[i].contains("depends_on")) continue;
+        for (const auto& dep : calls[i]["depends_on"]) {
+            auto it = ids.find(dep.get<std::string>());
+            if (it == ids.end()) {
+                throw std::runtime_error("Batch entry " + std::to_string(i) +
+                                         " depends on unknown id: " + dep.get<std::string>());
+            }
+            entries[i].depends_on.push_back(it->second);
+        }
+    }
+
+    std::vector<bool> visiting(entries.size(), false);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        assign_level(entries, i, visiting);
+    }
+
+    return entries;
+}
+
+} // namespace
+
+json execute_batch(PwnDocClient& client, const json& args) {
+    if (!args.contains("calls") || !args["calls"].is_array()) {
+        throw std::runtime_error("batch requires a 'calls' array");
+    }
+
+    std::vector<BatchEntry> entries = parse_entries(args["calls"]);
+
+    int limit = client.config().max_concurrency;
+    int max_parallel = std::clamp(args.value("max_parallel", limit), 1, limit);
+    long long timeout_ms = args.value("timeout_ms", 0LL);
+    bool fail_fast = args.value("fail_fast", false);
+
+    int max_level = -1;
+    for (const auto& entry : entries) {
+        max_level = std::max(max_level, entry.level);
+    }
+
+    std::vector<json> results(entries.size());
+    std::atomic<bool> aborted{false};
+    auto batch_start = std::chrono::steady_clock::now();
+
+    for (int level = 0; level <= max_level; ++level) {
+        std::vector<size_t> indices;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].level == level) indices.push_back(i);
+        }
+
+        parallel_for(indices.size(), static_cast<size_t>(max_parallel), [&](size_t k) {
+            size_t i = indices[k];
+            const BatchEntry& entry = entries[i];
+
+            json item = {{"index", i}, {"tool", entry.tool}};
+            if (!entry.id.empty()) item["id"] = entry.id;
+
+            if (aborted.load()) {
+                item["status"] = "skipped";
+                item["error"] = "Cancelled after an earlier failure (fail_fast)";
+                results[i] = std::move(item);
+                return;
+            }
+
+            // Earlier levels have completed, so their results are safe to read
+            for (size_t dep : entry.depends_on) {
+                if (results[dep]["status"] != "ok") {
+                    item["status"] = "skipped";
+                    item["error"] = "Dependency " + std::to_string(dep) + " did not succeed";
+                    results[i] = std::move(item);
+                    return;
+                }
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            try {
+                std::optional<RequestDeadline> deadline;
+                if (timeout_ms > 0) deadline.emplace(std::chrono::milliseconds(timeout_ms));
+
+                item["result"] = execute_tool(client, entry.tool, entry.arguments);
+                item["status"] = "ok";
+            } catch (const TimeoutError& e) {
+                item["status"] = "timeout";
+                item["error"] = e.what();
+            } catch (const std::exception& e) {
+                item["status"] = "error";
+                item["error"] = e.what();
+            }
+            item["elapsed_ms"] = elapsed_ms(start);
+
+            if (fail_fast && item["status"] != "ok") {
+                aborted.store(true);
+            }
+            results[i] = std::move(item);
+        });
+    }
+
+    int succeeded = 0, failed = 0, skipped = 0;
+    for (const auto& item : results) {
+        if (item["status"] == "ok") ++succeeded;
+        else if (item["status"] == "skipped") ++skipped;
+        else ++failed;
+    }
+
+    return {
+        {"results", results},
+        {"summary", {
+            {"total", entries.size()},
+            {"succeeded", succeeded},
+            {"failed", failed},
+            {"skipped", skipped},
+            {"elapsed_ms", elapsed_ms(batch_start)}
+        }}
+    };
+}
@@ -0,0 +1,569 @@
+#include "bulk.hpp"
+#include "id_map.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+namespace {
+
+size_t resolve_parallelism(const PwnDocClient& client, const json& args) {
+    int limit = client.config().max_concurrency;
+    return static_cast<size_t>(std::clamp(args.value("max_parallel", limit), 1, limit));
+}
+
+std::vector<std::string> finding_ids(const json& findings) {
+    std::vector<std::string> ids;
+    if (!findings.is_array()) return ids;
+    for (const auto& finding : findings) {
+        if (finding.contains("_id")) ids.push_back(finding["_id"].get<std::string>());
+    }
+    return ids;
+}
+
+json pipeline_summary(size_t requested, size_t succeeded, const PipelineStats& stats,
+                      const char* succeeded_key) {
+    double rate = stats.elapsed_seconds > 0.0 ? succeeded / stats.elapsed_seconds : 0.0;
+    return {
+        {"requested", requested},
+        {succeeded_key, succeeded},
+        {"failed", requested - succeeded},
+        {"elapsed_ms", static_cast<long long>(stats.elapsed_seconds * 1000)},
+        {"findings_per_second", std::round(rate * 100.0) / 100.0},
+        {"peak_concurrency", stats.peak_concurrency}
+    };
+}
+
+// String field of an object, or `fallback` when it is missing, null or not a string
+std::string string_field(const json& object, const char* key, const std::string& fallback) {
+    if (!object.is_object()) return fallback;
+    auto it = object.find(key);
+    return it != object.end() && it->is_string() ? it->get<std::string>() : fallback;
+}
+
+// Drop fields the server assigns, so an object can be written elsewhere
+json without_server_fields(json object) {
+    if (!object.is_object()) return object;
+    for (const char* key : {"_id", "__v", "createdAt", "updatedAt", "identifier", "creator"}) {
+        object.erase(key);
+    }
+    return object;
+}
+
+// Replace populated references ({_id, ...}) by their id
+json reference_ids(json general) {
+    for (const char* key : {"client", "company", "template", "collaborators", "reviewers"}) {
+        auto it = general.find(key);
+        if (it == general.end()) continue;
+        if (it->is_object() && it->contains("_id")) {
+            *it = (*it)["_id"];
+        } else if (it->is_array()) {
+            for (auto& entry : *it) {
+                if (entry.is_object() && entry.contains("_id")) entry = entry["_id"];
+            }
+        }
+    }
+    return general;
+}
+
+} // namespace
+
+std::vector<PipelineResult> run_pipelined(size_t count, size_t max_parallel,
+                                          const std::function<json(size_t)>& op,
+                                          PipelineStats& stats,
+                                          const std::function<void(size_t done)>& on_done) {
+    std::vector<PipelineResult> results(count);
+    std::mutex done_mutex;
+    size_t done = 0;
+    AdaptiveLimiter limiter(std::min<size_t>(2, max_parallel), max_parallel);
+    auto start = std::chrono::steady_clock::now();
+
+    parallel_for(count, max_parallel, [&](size_t i) {
+        limiter.acquire();
+        bool overloaded = false;
+        PipelineResult& result = results[i];
+        try {
+            result.response = op(i);
+            result.ok = true;
+        } catch (const RateLimitError& e) {
+            overloaded = true;
+            result.error = e.what();
+        } catch (const TimeoutError& e) {
+            overloaded = true;
+            result.error = e.what();
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+        limiter.release(overloaded);
+
+        if (on_done) {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            on_done(++done);
+        }
+    });
+
+    stats.elapsed_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    stats.peak_concurrency = limiter.peak();
+    return results;
+}
+
+void resolve_created_ids(const json& after, const std::set<std::string>& known,
+                         const std::vector<size_t>& pending, std::vector<std::string>& ids) {
+    if (pending.empty()) return;
+    std::vector<std::string> added;
+    for (const auto& id : finding_ids(after)) {
+        if (!known.count(id)) added.push_back(id);
+    }
+    if (added.size() != pending.size()) return;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        ids[pending[i]] = added[i];
+    }
+}
+
+json create_findings(PwnDocClient& client, const std::string& audit_id,
+                     const json& findings, bool sort, size_t max_parallel,
+                     const ProgressSink& progress) {
+    std::string endpoint = "/api/audits/" + audit_id + "/findings";
+
+    std::vector<std::string> existing_ids;
+    if (sort) {
+        existing_ids = finding_ids(response_datas(client.get(endpoint)));
+    }
+
+    auto create = [&](size_t i) {
+        json data = findings[i];
+        data.erase("audit_id");
+        return client.post(endpoint, data);
+    };
+    auto report = [&](size_t done) {
+        if (progress) progress(static_cast<double>(done), static_cast<double>(findings.size()),
+                               "Created " + std::to_string(done) + " of " + std::to_string(findings.size()) + " findings");
+    };
+
+    // Newer PwnDoc versions return the created finding; older ones only a
+    // message. Their new ids can then only be paired with the requests if
+    // the findings are created one at a time, so the first create probes.
+    PipelineStats stats;
+    std::vector<PipelineResult> results;
+    size_t first = 0;
+    if (sort && !findings.empty()) {
+        results = run_pipelined(1, 1, create, stats, report);
+        json datas = response_datas(results[0].response);
+        if (results[0].ok && !(datas.is_object() && datas.contains("_id"))) max_parallel = 1;
+        first = 1;
+    }
+    PipelineStats rest_stats;
+    auto rest = run_pipelined(findings.size() - first, max_parallel, [&](size_t i) {
+        return create(first + i);
+    }, rest_stats, [&](size_t done) { report(first + done); });
+    results.insert(results.end(), std::make_move_iterator(rest.begin()), std::make_move_iterator(rest.end()));
+    stats.elapsed_seconds += rest_stats.elapsed_seconds;
+    stats.peak_concurrency = std::max(stats.peak_concurrency, rest_stats.peak_concurrency);
+
+    std::vector<std::string> created_ids(findings.size());
+    size_t created = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].ok) continue;
+        ++created;
+        // Newer PwnDoc versions return the created finding; older ones only a message
+        json datas = response_datas(results[i].response);
+        if (datas.is_object() && datas.contains("_id")) {
+            created_ids[i] = datas["_id"].get<std::string>();
+        }
+    }
+
+    bool sorted = false;
+    if (sort && created > 0) {
+        json current = response_datas(client.get(endpoint));
+        std::vector<std::string> server_order = finding_ids(current);
+
+        // Findings that appeared during this call are the creates whose id
+        // was not returned
+        std::set<std::string> known(existing_ids.begin(), existing_ids.end());
+        known.insert(created_ids.begin(), created_ids.end());
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i].ok && created_ids[i].empty()) pending.push_back(i);
+        }
+        resolve_created_ids(current, known, pending, created_ids);
+
+        // Pre-existing findings keep their order, new ones follow in request order
+        std::set<std::string> present(server_order.begin(), server_order.end());
+        std::vector<std::string> order;
+        for (const auto& id : existing_ids) {
+            if (present.count(id)) order.push_back(id);
+        }
+        for (const auto& id : created_ids) {
+            if (!id.empty() && present.count(id)) order.push_back(id);
+        }
+        for (const auto& id : server_order) {
+            if (std::find(order.begin(), order.end(), id) == order.end()) order.push_back(id);
+        }
+
+        if (order != server_order) {
+            client.put("/api/audits/" + audit_id + "/sortFindings", {{"findings", order}});
+            sorted = true;
+        }
+    }
+
+    json items = json::array();
+    for (size_t i = 0; i < results.size(); ++i) {
+        json item = {
+            {"index", i},
+            {"title", findings[i].value("title", "")},
+            {"status", results[i].ok ? "created" : "error"}
+        };
+        if (!created_ids[i].empty()) item["finding_id"] = created_ids[i];
+        if (!results[i].ok) item["error"] = results[i].error;
+        items.push_back(std::move(item));
+    }
+
+    return {
+        {"audit_id", audit_id},
+        {"items", items},
+        {"sorted", sorted},
+        {"summary", pipeline_summary(findings.size(), created, stats, "created")}
+    };
+}
+
+json bulk_create_findings(PwnDocClient& client, const json& args) {
+    if (!args.contains("findings") || !args["findings"].is_array()) {
+        throw std::runtime_error("bulk_create_findings requires a 'findings' array");
+    }
+
+    return create_findings(client,
+                           args["audit_id"].get<std::string>(),
+                           args["findings"],
+                           args.value("sort", true),
+                           resolve_parallelism(client, args),
+                           ProgressScope::current());
+}
+
+json bulk_update_findings(PwnDocClient& client, const json& args) {
+    if (!args.contains("findings") || !args["findings"].is_array()) {
+        throw std::runtime_error("bulk_update_findings requires a 'findings' array");
+    }
+
+    std::string audit_id = args["audit_id"].get<std::string>();
+    const json& findings = args["findings"];
+    bool sort = args.value("sort", true);
+    std::string endpoint = "/api/audits/" + audit_id + "/findings";
+
+    std::vector<std::string> requested_ids;
+    for (const auto& finding : findings) {
+        if (!finding.contains("finding_id")) {
+            throw std::runtime_error("Every entry of 'findings' requires a 'finding_id'");
+        }
+        requested_ids.push_back(finding["finding_id"].get<std::string>());
+    }
+
+    std::vector<std::string> server_order;
+    if (sort) {
+        server_order = finding_ids(response_datas(client.get(endpoint)));
+    }
+
+    PipelineStats stats;
+    auto results = run_pipelined(findings.size(), resolve_parallelism(client, args), [&](size_t i) {
+        json data = findings[i];
+        data.erase("audit_id");
+        data.erase("finding_id");
+        return client.put(endpoint + "/" + requested_ids[i], data);
+    }, stats, [&, progress = ProgressScope::current()](size_t done) {
+        progress(static_cast<double>(done), static_cast<double>(findings.size()),
+                 "Updated " + std::to_string(done) + " of " + std::to_string(findings.size()) + " findings");
+    });
+
+    size_t updated = std::count_if(results.begin(), results.end(),
+                                   [](const PipelineResult& r) { return r.ok; });
+
+    // Refill the slots occupied by the requested findings in request order,
+    // leaving every other finding where it was
+    bool sorted = false;
+    if (sort) {
+        std::vector<std::string> wanted;
+        std::set<std::string> present(server_order.begin(), server_order.end());
+        for (const auto& id : requested_ids) {
+            if (present.count(id) && std::find(wanted.begin(), wanted.end(), id) == wanted.end()) {
+                wanted.push_back(id);
+            }
+        }
+        std::set<std::string> wanted_set(wanted.begin(), wanted.end());
+        std::vector<std::string> order = server_order;
+        size_t next = 0;
+        for (auto& id : order) {
+            if (wanted_set.count(id)) id = wanted[next++];
+        }
+
+        if (order != server_order) {
+            client.put("/api/audits/" + audit_id + "/sortFindings", {{"findings", order}});
+            sorted = true;
+        }
+    }
+
+    json items = json::array();
+    for (size_t i = 0; i < results.size(); ++i) {
+        json item = {
+            {"index", i},
+            {"finding_id", requested_ids[i]},
+            {"status", results[i].ok ? "updated" : "error"}
+        };
+        if (!results[i].ok) item["error"] = results[i].error;
+        items.push_back(std::move(item));
+    }
+
+    return {
+        {"audit_id", audit_id},
+        {"items", items},
+        {"sorted", sorted},
+        {"summary", pipeline_summary(findings.size(), updated, stats, "updated")}
+    };
+}
+
+json bulk_move_findings(PwnDocClient& client, const json& args) {
+    if (!args.contains("finding_ids") || !args["finding_ids"].is_array()) {
+        throw std::runtime_error("bulk_move_findings requires a 'finding_ids' array");
+    }
+
+    std::string source_id = args["audit_id"].get<std::string>();
+    std::string destination_id = args["destination_audit_id"].get<std::string>();
+    if (source_id == destination_id) {
+        throw std::runtime_error("Source and destination audit are the same");
+    }
+    std::vector<std::string> requested_ids = args["finding_ids"].get<std::vector<std::string>>();
+    bool sort = args.value("sort", true);
+    size_t max_parallel = resolve_parallelism(client, args);
+    std::string source = "/api/audits/" + source_id + "/findings";
+    std::string destination = "/api/audits/" + destination_id + "/findings";
+
+    // Orders before the move: the source keeps its remaining findings in
+    // place, the destination appends the moved ones in request order
+    json source_before;
+    json destination_before;
+    if (sort) {
+        parallel_for(2, max_parallel, [&](size_t i) {
+            if (i == 0) source_before = response_datas(client.get(source));
+            else destination_before = response_datas(client.get(destination));
+        });
+    }
+
+    PipelineStats stats;
+    auto results = run_pipelined(requested_ids.size(), max_parallel, [&](size_t i) {
+        return client.post(source + "/" + requested_ids[i] + "/move/" + destination_id, json::object());
+    }, stats, [&, progress = ProgressScope::current()](size_t done) {
+        progress(static_cast<double>(done), static_cast<double>(requested_ids.size()),
+                 "Moved " + std::to_string(done) + " of " + std::to_string(requested_ids.size()) + " findings");
+    });
+
+    size_t moved = std::count_if(results.begin(), results.end(),
+                                 [](const PipelineResult& r) { return r.ok; });
+
+    bool source_sorted = false;
+    bool destination_sorted = false;
+    if (sort && moved > 0) {
+        json source_after;
+        json destination_after;
+        parallel_for(2, max_parallel, [&](size_t i) {
+            if (i == 0) source_after = response_datas(client.get(source));
+            else destination_after = response_datas(client.get(destination));
+        });
+
+        // Source: previous order without the findings that left
+        std::vector<std::string> source_order = finding_ids(source_after);
+        std::set<std::string> remaining(source_order.begin(), source_order.end());
+        std::vector<std::string> source_wanted;
+        for (const auto& id : finding_ids(source_before)) {
+            if (remaining.count(id)) source_wanted.push_back(id);
+        }
+        for (const auto& id : source_order) {
+            if (std::find(source_wanted.begin(), source_wanted.end(), id) == source_wanted.end()) {
+                source_wanted.push_back(id);
+            }
+        }
+        if (source_wanted != source_order) {
+            client.put("/api/audits/" + source_id + "/sortFindings", {{"findings", source_wanted}});
+            source_sorted = true;
+        }
+
+        // Destination: previous findings first, then the moved ones in
+        // request order. A moved finding keeps its id. If the server issued
+        // a new one, it is the id that appeared in the destination, which
+        // can only be told apart when a single moved finding lacks its id;
+        // otherwise the new ids follow in server order.
+        std::vector<std::string> destination_order = finding_ids(destination_after);
+        std::set<std::string> present(destination_order.begin(), destination_order.end());
+        std::vector<std::string> previous = finding_ids(destination_before);
+        std::set<std::string> known(previous.begin(), previous.end());
+        known.insert(requested_ids.begin(), requested_ids.end());
+
+        std::vector<std::string> moved_ids(requested_ids.size());
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < requested_ids.size(); ++i) {
+            if (!results[i].ok) continue;
+            if (present.count(requested_ids[i])) moved_ids[i] = requested_ids[i];
+            else pending.push_back(i);
+        }
+        if (pending.size() == 1) resolve_created_ids(destination_after, known, pending, moved_ids);
+
+        std::vector<std::string> destination_wanted;
+        for (const auto& id : previous) {
+            if (present.count(id)) destination_wanted.push_back(id);
+        }
+        for (const auto& id : moved_ids) {
+            if (id.empty()) continue;
+            if (std::find(destination_wanted.begin(), destination_wanted.end(), id) == destination_wanted.end()) {
+                destination_wanted.push_back(id);
+            }
+        }
+        for (const auto& id : destination_order) {
+            if (std::find(destination_wanted.begin(), destination_wanted.end(), id) == destination_wanted.end()) {
+                destination_wanted.push_back(id);
+            }
+        }
+        if (destination_wanted != destination_order) {
+            client.put("/api/audits/" + destination_id + "/sortFindings", {{"findings", destination_wanted}});
+            destination_sorted = true;
+        }
+    }
+
+    json items = json::array();
+    for (size_t i = 0; i < results.size(); ++i) {
+        json item = {
+            {"index", i},
+            {"finding_id", requested_ids[i]},
+            {"status", results[i].ok ? "moved" : "error"}
+        };
+        if (!results[i].ok) item["error"] = results[i].error;
+        items.push_back(std::move(item));
+    }
+
+    return {
+        {"audit_id", source_id},
+        {"destination_audit_id", destination_id},
+        {"items", items},
+        {"sorted", {{"source", source_sorted}, {"destination", destination_sorted}}},
+        {"summary", pipeline_summary(requested_ids.size(), moved, stats, "moved")}
+    };
+}
+
+json clone_audit(PwnDocClient& client, const json& args) {
+    std::string source_id = args["audit_id"].get<std::string>();
+    std::string source = "/api/audits/" + source_id;
+    bool copy_findings = args.value("include_findings", true);
+    bool copy_sections = args.value("include_sections", true);
+    bool copy_network = args.value("include_network", true);
+    size_t max_parallel = resolve_parallelism(client, args);
+    auto start = std::chrono::steady_clock::now();
+
+    // Fetch the parts of the source audit concurrently
+    std::vector<std::string> parts = {"general"};
+    if (copy_findings) parts.push_back("findings");
+    if (copy_sections) parts.push_back("sections");
+    if (copy_network) parts.push_back("network");
+    std::map<std::string, json> fetched;
+    std::mutex fetched_mutex;
+    parallel_for(parts.size(), max_parallel, [&](size_t i) {
+        json datas = response_datas(client.get(source + "/" + parts[i]));
+        std::lock_guard<std::mutex> lock(fetched_mutex);
+        fetched[parts[i]] = std::move(datas);
+    });
+
+    json general = reference_ids(without_server_fields(fetched["general"]));
+    // Arguments take precedence; the source's fields may be null
+    std::string name = string_field(args, "name", string_field(general, "name", "Audit") + " (copy)");
+    std::string language = string_field(args, "language", "");
+    if (language.empty()) language = string_field(general, "language", "");
+    std::string audit_type = string_field(args, "audit_type", "");
+    if (audit_type.empty()) audit_type = string_field(general, "auditType", "");
+    json create = {
+        {"name", name},
+        {"language", language},
+        {"auditType", audit_type}
+    };
+    if (create["language"] == "" || create["auditType"] == "") {
+        throw std::runtime_error("Source audit has no language or audit type; pass 'language' and 'audit_type'");
+    }
+
+    // PwnDoc answers {message, audit: {_id}}; accept a bare object as well
+    json created = response_datas(client.post("/api/audits", create));
+    if (created.is_object() && created.contains("audit")) created = created["audit"];
+    if (!created.is_object() || !created.contains("_id")) {
+        throw PwnDocError("Audit was created but its id was not returned");
+    }
+    std::string audit_id = created["_id"].get<std::string>();
+    std::string target = "/api/audits/" + audit_id;
+
+    // Copy the images referenced by the copied parts into the new audit, and
+    // point the copy at them, as restore does
+    std::set<std::string> referenced;
+    for (const auto& part : parts) collect_image_ids(fetched[part], referenced);
+    std::vector<std::string> image_ids(referenced.begin(), referenced.end());
+    IdMap ids;
+    PipelineStats image_stats;
+    auto image_results = run_pipelined(image_ids.size(), max_parallel, [&](size_t i) {
+        json image = without_server_fields(response_datas(client.get("/api/images/" + image_ids[i])));
+        image["auditId"] = audit_id;
+        json copy = response_datas(client.post("/api/images", image));
+        if (!copy.is_object() || !copy.contains("_id")) {
+            throw PwnDocError("Image was created but its id was not returned");
+        }
+        ids.put(image_ids[i], copy["_id"].get<std::string>());
+        return copy["_id"];
+    }, image_stats);
+    for (auto& [part, datas] : fetched) ids.remap(datas);
+    ids.remap(general);
+
+    // Copy the metadata concurrently; failures are reported per part
+    general["name"] = name;
+    std::vector<std::pair<std::string, json>> writes = {{"general", general}};
+    if (copy_sections) writes.emplace_back("sections", without_server_fields(fetched["sections"]));
+    if (copy_network) writes.emplace_back("network", without_server_fields(fetched["network"]));
+    PipelineStats write_stats;
+    auto write_results = run_pipelined(writes.size(), max_parallel, [&](size_t i) {
+        return client.put(target + "/" + writes[i].first, writes[i].second);
+    }, write_stats);
+
+    json copied = json::object();
+    for (size_t i = 0; i < writes.size(); ++i) {
+        copied[writes[i].first] = write_results[i].ok ? json("copied") : json({{"error", write_results[i].error}});
+    }
+
+    json result = {
+        {"source_audit_id", source_id},
+        {"audit_id", audit_id},
+        {"name", name},
+        {"copied", copied}
+    };
+    if (!image_ids.empty()) {
+        json failed = json::array();
+        for (size_t i = 0; i < image_ids.size(); ++i) {
+            if (!image_results[i].ok) failed.push_back({{"image_id", image_ids[i]}, {"error", image_results[i].error}});
+        }
+        result["images"] = {{"copied", ids.size()}, {"failed", failed}};
+    }
+
+    if (copy_findings) {
+        json findings = json::array();
+        if (fetched["findings"].is_array()) {
+            for (const auto& finding : fetched["findings"]) {
+                findings.push_back(without_server_fields(finding));
+            }
+        }
+        json outcome = create_findings(client, audit_id, findings, true, max_parallel, ProgressScope::current());
+        result["findings"] = {
+            {"items", outcome["items"]},
+            {"sorted", outcome["sorted"]},
+            {"summary", outcome["summary"]}
+        };
+    }
+
+    result["elapsed_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
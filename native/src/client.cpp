@@ -1,14 +1,26 @@
 #include "client.hpp"
+#include "projection.hpp"
+#include "sha256.hpp"
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
 #include <thread>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
+#include <mutex>
 
 using json = nlohmann::json;
 
+// Serializes log lines written from concurrent requests
+static std::mutex log_mutex;
+
+// Deadline set by RequestDeadline for the current thread
+static thread_local std::optional<std::chrono::steady_clock::time_point> current_deadline;
+
 // CURL write callback
 static size_t write_callback(void* contents, size_t size, size_t nmemb, std::string* data) {
     size_t total = size * nmemb;
@@ -16,6 +28,124 @@ static size_t write_callback(void* contents, size_t size, size_t nmemb, std::str
     return total;
 }
 
+/**
+ * Destination of a streamed download: the body goes to a temporary file and
+ * through the optional hasher; error responses are kept for the message
+ */
+struct DownloadSink {
+    CURL* curl = nullptr;
+    std::string part_path;
+    std::ofstream file;
+    std::optional<Sha256> sha;
+    size_t bytes = 0;
+    std::string error_body;
+    std::string filename;
+    std::string content_type;
+    long timeout_ms = 0;
+
+    // Start over for a new attempt
+    void reset() {
+        file.close();
+        file.open(part_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw PwnDocError("Cannot write " + part_path);
+        }
+        if (sha) sha->reset();
+        bytes = 0;
+        error_body.clear();
+        filename.clear();
+    }
+};
+
+static size_t download_write_callback(char* data, size_t size, size_t nmemb, DownloadSink* sink) {
+    size_t total = size * nmemb;
+    long http_code = 0;
+    curl_easy_getinfo(sink->curl, CURLINFO_RESPONSE_CODE, &http_code);
+    if (http_code >= 400) {
+        sink->error_body.append(data, total);
+        return total;
+    }
+
+    sink->file.write(data, static_cast<std::streamsize>(total));
+    if (!sink->file) return 0;  // aborts the transfer with CURLE_WRITE_ERROR
+    if (sink->sha) sink->sha->update(data, total);
+    sink->bytes += total;
+    return total;
+}
+
+// Picks the file name out of "Content-Disposition: attachment; filename=..."
+static size_t download_header_callback(char* data, size_t size, size_t nitems, DownloadSink* sink) {
+    size_t total = size * nitems;
+    std::string line(data, total);
+    std::string lower = line;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower.rfind("content-disposition:", 0) != 0) return total;
+
+    size_t pos = lower.find("filename=");
+    if (pos == std::string::npos) return total;
+    std::string name = line.substr(pos + 9);
+    name = name.substr(0, name.find_first_of(";\r\n"));
+    if (!name.empty() && name.front() == '"') name = name.substr(1, name.find('"', 1) - 1);
+    // Never let the server pick a directory
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos) name = name.substr(slash + 1);
+    if (name != "." && name != "..") sink->filename = name;
+    return total;
+}
+
+/**
+ * Read position in an UploadSource for one attempt
+ */
+struct UploadReader {
+    const UploadSource* source;
+    int part = 0;        // 0: head, 1: file, 2: tail
+    size_t offset = 0;
+
+    explicit UploadReader(const UploadSource* source) : source(source) {
+        if (source->file && std::fseek(source->file, 0, SEEK_SET) != 0) {
+            throw PwnDocError("Cannot rewind the request body");
+        }
+    }
+
+    curl_off_t size() const {
+        curl_off_t total = static_cast<curl_off_t>(source->head.size() + source->tail.size());
+        if (source->file) {
+            long pos = std::ftell(source->file);
+            std::fseek(source->file, 0, SEEK_END);
+            total += std::ftell(source->file);
+            std::fseek(source->file, pos, SEEK_SET);
+        }
+        return total;
+    }
+};
+
+static size_t upload_read_callback(char* buffer, size_t size, size_t nitems, UploadReader* reader) {
+    size_t capacity = size * nitems;
+    size_t written = 0;
+    while (written < capacity && reader->part < 3) {
+        if (reader->part == 1) {
+            size_t n = reader->source->file
+                ? std::fread(buffer + written, 1, capacity - written, reader->source->file) : 0;
+            if (n == 0) {
+                if (reader->source->file && std::ferror(reader->source->file)) return CURL_READFUNC_ABORT;
+                ++reader->part;
+            }
+            written += n;
+            continue;
+        }
+        const std::string& text = reader->part == 0 ? reader->source->head : reader->source->tail;
+        size_t n = std::min(capacity - written, text.size() - reader->offset);
+        std::memcpy(buffer + written, text.data() + reader->offset, n);
+        written += n;
+        reader->offset += n;
+        if (reader->offset == text.size()) {
+            ++reader->part;
+            reader->offset = 0;
+        }
+    }
+    return written;
+}
+
 // Helper to get current timestamp for logging
 static std::string get_timestamp() {
     auto now = std::time(nullptr);
@@ -68,20 +198,65 @@ double RateLimiter::wait_time() const {
     return wait > 0.0 ? wait : 0.0;
 }
 
+json response_datas(const json& response) {
+    if (response.is_object() && response.contains("datas")) {
+        return response["datas"];
+    }
+    return response;
+}
+
+// ============================================================================
+// RequestDeadline Implementation
+// ============================================================================
+
+RequestDeadline::RequestDeadline(std::chrono::milliseconds budget)
+    : previous_(current_deadline) {
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    // Nested deadlines can only tighten the outer one
+    if (!current_deadline || deadline < *current_deadline) {
+        current_deadline = deadline;
+    }
+}
+
+RequestDeadline::RequestDeadline(std::optional<std::chrono::steady_clock::time_point> deadline)
+    : previous_(current_deadline) {
+    if (deadline && (!current_deadline || *deadline < *current_deadline)) {
+        current_deadline = deadline;
+    }
+}
+
+RequestDeadline::~RequestDeadline() {
+    current_deadline = previous_;
+}
+
+std::optional<std::chrono::steady_clock::time_point> RequestDeadline::current() {
+    return current_deadline;
+}
+
 // ============================================================================
 // PwnDocClient Implementation
 // ============================================================================
 
 PwnDocClient::PwnDocClient(const Config& config)
     : config_(config),
-      curl_(nullptr),
-      rate_limiter_(config.rate_limit_max_requests, config.rate_limit_period) {
+      rate_limiter_(config.rate_limit_max_requests, config.rate_limit_period),
+      write_coalescer_(std::chrono::milliseconds(config.coalesce_window_ms)),
+      object_cache_(std::chrono::seconds(config.cache_ttl)),
+      image_index_(Config::get_data_dir().empty() ? "" : Config::get_data_dir() + "/image-index.json",
+                   config.url, ImageIndex::parse_scope(config.image_dedup)),
+      report_cache_(Config::get_data_dir().empty() ? "" : Config::get_data_dir() + "/report-cache",
+                    static_cast<uint64_t>(std::max(0, config.report_cache_mb)) * 1024 * 1024),
+      result_store_(Config::get_data_dir().empty() ? "" : Config::get_data_dir() + "/results",
+                    static_cast<uint64_t>(std::max(0, config.spill_threshold_kb)) * 1024),
+      list_pages_(std::chrono::minutes(10)),
+      report_jobs_(static_cast<size_t>(std::max(1, config.report_workers))) {
 
     curl_global_init(CURL_GLOBAL_DEFAULT);
-    curl_ = curl_easy_init();
-    if (!curl_) {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
         throw PwnDocError("Failed to initialize CURL");
     }
+    idle_handles_.push_back(curl);
 
     // Set token if provided
     if (config_.token) {
@@ -93,30 +268,55 @@ PwnDocClient::PwnDocClient(const Config& config)
 }
 
 PwnDocClient::~PwnDocClient() {
-    if (curl_) {
-        curl_easy_cleanup(curl_);
+    for (CURL* curl : idle_handles_) {
+        curl_easy_cleanup(curl);
     }
     curl_global_cleanup();
 }
 
+CURL* PwnDocClient::acquire_handle() {
+    {
+        std::lock_guard<std::mutex> lock(handles_mutex_);
+        if (!idle_handles_.empty()) {
+            CURL* curl = idle_handles_.back();
+            idle_handles_.pop_back();
+            return curl;
+        }
+    }
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        throw PwnDocError("Failed to initialize CURL");
+    }
+    return curl;
+}
+
+void PwnDocClient::release_handle(CURL* curl) {
+    std::lock_guard<std::mutex> lock(handles_mutex_);
+    idle_handles_.push_back(curl);
+}
+
 // ============================================================================
 // Logging Methods
 // ============================================================================
 
 void PwnDocClient::log_info(const std::string& message) const {
     if (config_.log_level <= 0) { // 0 = INFO
+        std::lock_guard<std::mutex> lock(log_mutex);
         std::cout << "[" << get_timestamp() << "] INFO: " << message << std::endl;
     }
 }
 
 void PwnDocClient::log_warning(const std::string& message) const {
     if (config_.log_level <= 1) { // 1 = WARNING
+        std::lock_guard<std::mutex> lock(log_mutex);
         std::cerr << "[" << get_timestamp() << "] WARNING: " << message << std::endl;
     }
 }
 
 void PwnDocClient::log_debug(const std::string& message) const {
     if (config_.log_level <= -1) { // -1 = DEBUG
+        std::lock_guard<std::mutex> lock(log_mutex);
         std::cout << "[" << get_timestamp() << "] DEBUG: " << message << std::endl;
     }
 }
@@ -139,19 +339,25 @@ struct curl_slist* PwnDocClient::build_headers(bool include_auth) {
     struct curl_slist* headers = nullptr;
     headers = curl_slist_append(headers, "Content-Type: application/json");
 
-    if (include_auth && !token_.empty()) {
-        std::string auth_header = "Authorization: JWT " + token_;
+    std::string token;
+    {
+        std::lock_guard<std::recursive_mutex> lock(auth_mutex_);
+        token = token_;
+    }
+
+    if (include_auth && !token.empty()) {
+        std::string auth_header = "Authorization: JWT " + token;
         headers = curl_slist_append(headers, auth_header.c_str());
     }
 
     return headers;
 }
 
-std::map<std::string, std::string> PwnDocClient::get_cookies() {
+std::map<std::string, std::string> PwnDocClient::get_cookies(CURL* curl) {
     std::map<std::string, std::string> cookies;
 
     struct curl_slist* cookie_list = nullptr;
-    curl_easy_getinfo(curl_, CURLINFO_COOKIELIST, &cookie_list);
+    curl_easy_getinfo(curl, CURLINFO_COOKIELIST, &cookie_list);
 
     if (cookie_list) {
         struct curl_slist* current = cookie_list;
@@ -180,6 +386,8 @@ std::map<std::string, std::string> PwnDocClient::get_cookies() {
 // ============================================================================
 
 void PwnDocClient::ensure_authenticated() {
+    std::lock_guard<std::recursive_mutex> lock(auth_mutex_);
+
     // Check if token is expired
     if (token_expires_.has_value()) {
         auto now = std::chrono::steady_clock::now();
@@ -212,6 +420,7 @@ bool PwnDocClient::authenticate() {
         throw AuthenticationError("Username and password required for authentication");
     }
 
+    std::lock_guard<std::recursive_mutex> lock(auth_mutex_);
     log_info("Authenticating user: " + *config_.username);
 
     json login_data = {
@@ -222,28 +431,30 @@ bool PwnDocClient::authenticate() {
     std::string url = build_url("/users/login");
     std::string response_data;
 
-    curl_easy_reset(curl_);
-    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl_, CURLOPT_COOKIEFILE, ""); // Enable cookie engine
+    HandleLease lease(*this);
+    CURL* curl = lease.get();
+    curl_easy_reset(curl);
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, ""); // Enable cookie engine
 
     std::string body = login_data.dump();
-    curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, body.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
 
     struct curl_slist* headers = build_headers(false);
-    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_data);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
 
     if (!config_.verify_ssl) {
-        curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYHOST, 0L);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
     }
 
-    curl_easy_setopt(curl_, CURLOPT_TIMEOUT, config_.timeout);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, config_.timeout);
 
-    CURLcode res = curl_easy_perform(curl_);
+    CURLcode res = curl_easy_perform(curl);
     curl_slist_free_all(headers);
 
     if (res != CURLE_OK) {
@@ -251,7 +462,7 @@ bool PwnDocClient::authenticate() {
     }
 
     long http_code = 0;
-    curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &http_code);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
 
     if (http_code == 401) {
         throw AuthenticationError("Invalid username or password");
@@ -270,7 +481,7 @@ bool PwnDocClient::authenticate() {
         token_expires_ = now + std::chrono::hours(1);
 
         // Extract refresh token from cookies
-        auto cookies = get_cookies();
+        auto cookies = get_cookies(curl);
         if (cookies.find("refreshToken") != cookies.end()) {
             refresh_token_ = cookies["refreshToken"];
             log_debug("Refresh token obtained from cookies");
@@ -284,6 +495,7 @@ bool PwnDocClient::authenticate() {
 }
 
 bool PwnDocClient::refresh_authentication() {
+    std::lock_guard<std::recursive_mutex> lock(auth_mutex_);
     if (!refresh_token_.has_value()) {
         log_warning("No refresh token available");
         return false;
@@ -294,30 +506,32 @@ bool PwnDocClient::refresh_authentication() {
     std::string url = build_url("/users/refreshtoken");
     std::string response_data;
 
-    curl_easy_reset(curl_);
-    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, "");
-    curl_easy_setopt(curl_, CURLOPT_COOKIEFILE, "");
+    HandleLease lease(*this);
+    CURL* curl = lease.get();
+    curl_easy_reset(curl);
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "");
+    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, "");
 
     // Set refresh token cookie
     std::string cookie = "refreshToken=" + *refresh_token_;
-    curl_easy_setopt(curl_, CURLOPT_COOKIE, cookie.c_str());
+    curl_easy_setopt(curl, CURLOPT_COOKIE, cookie.c_str());
 
     struct curl_slist* headers = build_headers(false);
-    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_data);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
 
     if (!config_.verify_ssl) {
-        curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYHOST, 0L);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
     }
 
-    curl_easy_setopt(curl_, CURLOPT_TIMEOUT, config_.timeout);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, config_.timeout);
 
-    CURLcode res = curl_easy_perform(curl_);
+    CURLcode res = curl_easy_perform(curl);
     curl_slist_free_all(headers);
 
     if (res != CURLE_OK) {
@@ -326,7 +540,7 @@ bool PwnDocClient::refresh_authentication() {
     }
 
     long http_code = 0;
-    curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &http_code);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
 
     if (http_code != 200) {
         log_warning("Token refresh failed with HTTP " + std::to_string(http_code));
@@ -349,6 +563,7 @@ bool PwnDocClient::refresh_authentication() {
 }
 
 bool PwnDocClient::is_authenticated() const {
+    std::lock_guard<std::recursive_mutex> lock(auth_mutex_);
     return !token_.empty();
 }
 
@@ -357,13 +572,14 @@ bool PwnDocClient::is_authenticated() const {
 // ============================================================================
 
 void PwnDocClient::wait_for_rate_limit() {
-    if (!rate_limiter_.acquire()) {
-        double wait = rate_limiter_.wait_time();
-        if (wait > 0) {
-            log_warning("Rate limit reached, waiting " + std::to_string(wait) + " seconds");
-            std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(wait * 1000)));
-            rate_limiter_.acquire(); // Try again after waiting
-        }
+    std::unique_lock<std::mutex> lock(rate_mutex_);
+    // Loop rather than retry once: concurrent requests may take the freed slot first
+    while (!rate_limiter_.acquire()) {
+        double wait = std::max(rate_limiter_.wait_time(), 0.05);
+        lock.unlock();
+        log_warning("Rate limit reached, waiting " + std::to_string(wait) + " seconds");
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(wait * 1000)));
+        lock.lock();
     }
 }
 
@@ -374,57 +590,109 @@ void PwnDocClient::wait_for_rate_limit() {
 json PwnDocClient::request(const std::string& method,
                            const std::string& endpoint,
                            const json& data) {
+    return request_raw(method, endpoint, data.empty() ? std::string() : data.dump());
+}
+
+json PwnDocClient::request_raw(const std::string& method,
+                               const std::string& endpoint,
+                               const std::string& body,
+                               DownloadSink* sink,
+                               const UploadSource* upload) {
     ensure_authenticated();
     wait_for_rate_limit();
 
     std::string url = build_url(endpoint);
     log_debug(method + " " + url);
 
+    HandleLease lease(*this);
+    CURL* curl = lease.get();
+
     // Retry loop with exponential backoff
     for (int attempt = 0; attempt < config_.max_retries; ++attempt) {
         std::string response_data;
 
-        curl_easy_reset(curl_);
-        curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
+        long timeout_ms = static_cast<long>(config_.timeout) * 1000;
+        if (sink && sink->timeout_ms > 0) timeout_ms = sink->timeout_ms;
+        bool deadline_bound = false;
+        if (auto deadline = RequestDeadline::current()) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                *deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                throw TimeoutError("Deadline exceeded before " + method + " " + endpoint);
+            }
+            if (remaining < timeout_ms) {
+                timeout_ms = static_cast<long>(remaining);
+                deadline_bound = true;
+            }
+        }
+
+        curl_easy_reset(curl);
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
 
         // Set method
         if (method == "POST") {
-            curl_easy_setopt(curl_, CURLOPT_POST, 1L);
+            curl_easy_setopt(curl, CURLOPT_POST, 1L);
         } else if (method == "PUT") {
-            curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, "PUT");
+            curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
         } else if (method == "DELETE") {
-            curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, "DELETE");
+            curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
         }
         // GET is default, no need to set
 
         // Set body for POST/PUT/DELETE
-        std::string body;
-        if (!data.empty()) {
-            body = data.dump();
-            curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, body.c_str());
+        std::optional<UploadReader> reader;
+        if (upload) {
+            reader.emplace(upload);
+            curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+            curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, reader->size());
+            curl_easy_setopt(curl, CURLOPT_READFUNCTION, upload_read_callback);
+            curl_easy_setopt(curl, CURLOPT_READDATA, &*reader);
+        } else if (!body.empty() || method == "POST") {
+            // An empty POST still sets its (empty) fields, or CURL would read
+            // the body from stdin, which is the MCP channel
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.size()));
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.data());
         }
 
         // Set headers
         struct curl_slist* headers = build_headers(true);
-        curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
-
-        curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, write_callback);
-        curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_data);
+        if (upload) {
+            // Send the body right away instead of waiting for "100 Continue"
+            headers = curl_slist_append(headers, "Expect:");
+        }
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+
+        if (sink) {
+            sink->reset();
+            sink->curl = curl;
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, download_write_callback);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, sink);
+            curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, download_header_callback);
+            curl_easy_setopt(curl, CURLOPT_HEADERDATA, sink);
+        } else {
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
+        }
 
         if (!config_.verify_ssl) {
-            curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, 0L);
-            curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYHOST, 0L);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
         }
 
-        curl_easy_setopt(curl_, CURLOPT_TIMEOUT, config_.timeout);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
 
-        CURLcode res = curl_easy_perform(curl_);
+        CURLcode res = curl_easy_perform(curl);
         curl_slist_free_all(headers);
 
         // Handle CURL errors with retry
         if (res != CURLE_OK) {
             std::string error_msg = std::string("Request failed: ") + curl_easy_strerror(res);
 
+            // Retrying is pointless once the caller's deadline has been used up
+            if (res == CURLE_OPERATION_TIMEDOUT && deadline_bound) {
+                throw TimeoutError(error_msg);
+            }
+
             if (attempt < config_.max_retries - 1) {
                 int delay_ms = static_cast<int>(config_.retry_delay * std::pow(2, attempt) * 1000);
                 log_warning(error_msg + " (attempt " + std::to_string(attempt + 1) +
@@ -438,7 +706,7 @@ json PwnDocClient::request(const std::string& method,
         }
 
         long http_code = 0;
-        curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &http_code);
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
 
         log_debug("Response: HTTP " + std::to_string(http_code));
 
@@ -446,7 +714,13 @@ json PwnDocClient::request(const std::string& method,
         if (http_code == 401) {
             log_warning("Received 401 Unauthorized, attempting token refresh");
 
-            if (refresh_token_.has_value() && refresh_authentication()) {
+            bool can_refresh;
+            {
+                std::lock_guard<std::recursive_mutex> lock(auth_mutex_);
+                can_refresh = refresh_token_.has_value();
+            }
+
+            if (can_refresh && refresh_authentication()) {
                 log_info("Token refreshed, retrying request");
                 continue; // Retry with new token
             } else if (config_.username && config_.password) {
@@ -477,6 +751,7 @@ json PwnDocClient::request(const std::string& method,
 
         // Handle other HTTP errors
         if (http_code >= 400) {
+            if (sink) response_data = sink->error_body;
             std::string error_detail = "HTTP " + std::to_string(http_code);
 
             // Try to parse error message from response
@@ -497,9 +772,23 @@ json PwnDocClient::request(const std::string& method,
             throw PwnDocError(error_detail);
         }
 
-        // Success - parse and return response
+        // Success - a streamed body is already on disk
+        if (sink) {
+            sink->file.close();
+            if (!sink->file) {
+                throw PwnDocError("Failed to write " + sink->part_path);
+            }
+            char* content_type = nullptr;
+            curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &content_type);
+            sink->content_type = content_type ? content_type : "";
+            return json({{"success", true}});
+        }
+
+        // Success - parse and return response, dropping unselected fields
+        // while parsing when a projection is active
         try {
-            return json::parse(response_data);
+            const FieldProjection* projection = ProjectionScope::current();
+            return projection ? json::parse(response_data, projection->callback()) : json::parse(response_data);
         } catch (const json::parse_error& e) {
             // If response is empty or not JSON, return success indicator
             if (response_data.empty()) {
@@ -522,15 +811,136 @@ json PwnDocClient::get(const std::string& endpoint) {
 }
 
 json PwnDocClient::post(const std::string& endpoint, const json& data) {
-    return request("POST", endpoint, data);
+    object_cache_.invalidate(endpoint);
+    json result = request("POST", endpoint, data);
+    object_cache_.invalidate(endpoint);
+    return result;
 }
 
 json PwnDocClient::put(const std::string& endpoint, const json& data) {
-    return request("PUT", endpoint, data);
+    object_cache_.invalidate(endpoint);
+    json result = request("PUT", endpoint, data);
+    object_cache_.invalidate(endpoint);
+    return result;
+}
+
+json PwnDocClient::post_raw(const std::string& endpoint, const std::string& body) {
+    object_cache_.invalidate(endpoint);
+    json result = request_raw("POST", endpoint, body);
+    object_cache_.invalidate(endpoint);
+    return result;
+}
+
+json PwnDocClient::put_raw(const std::string& endpoint, const std::string& body) {
+    object_cache_.invalidate(endpoint);
+    json result = request_raw("PUT", endpoint, body);
+    object_cache_.invalidate(endpoint);
+    return result;
+}
+
+json PwnDocClient::put_stream(const std::string& endpoint, const UploadSource& source) {
+    object_cache_.invalidate(endpoint);
+    json result = request_raw("PUT", endpoint, std::string(), nullptr, &source);
+    object_cache_.invalidate(endpoint);
+    return result;
 }
 
 json PwnDocClient::del(const std::string& endpoint, const json& data) {
-    return request("DELETE", endpoint, data);
+    object_cache_.invalidate(endpoint);
+    json result = request("DELETE", endpoint, data);
+    object_cache_.invalidate(endpoint);
+    return result;
+}
+
+DownloadResult PwnDocClient::download(const std::string& endpoint, const std::string& path,
+                                     bool sha256, const std::string& fallback_name,
+                                     std::chrono::seconds timeout) {
+    namespace fs = std::filesystem;
+
+    bool into_directory = path.empty() || path.back() == '/' || path.back() == '\\' || fs::is_directory(path);
+    fs::path directory = into_directory ? fs::path(path) : fs::path(path).parent_path();
+    if (!directory.empty()) {
+        fs::create_directories(directory);
+    }
+
+    DownloadSink sink;
+    // Unique per concurrent download into the same directory
+    std::ostringstream part_name;
+    part_name << ".download-" << std::this_thread::get_id() << ".part";
+    sink.part_path = into_directory ? (directory / part_name.str()).string() : path + ".part";
+    if (sha256) sink.sha.emplace();
+    sink.timeout_ms = static_cast<long>(timeout.count()) * 1000;
+
+    try {
+        request_raw("GET", endpoint, "", &sink);
+    } catch (...) {
+        sink.file.close();
+        std::error_code ignored;
+        fs::remove(sink.part_path, ignored);
+        throw;
+    }
+
+    fs::path target = path;
+    if (into_directory) {
+        std::string name = sink.filename;
+        if (name.empty()) name = fallback_name;
+        if (name.empty()) name = endpoint.substr(endpoint.find_last_of('/') + 1);
+        target = directory / name;
+    }
+    fs::rename(sink.part_path, target);
+
+    DownloadResult result;
+    result.path = fs::absolute(target).string();
+    result.bytes = sink.bytes;
+    result.content_type = sink.content_type;
+    if (sink.sha) result.sha256 = sink.sha->hex_digest();
+    log_debug("Downloaded " + std::to_string(result.bytes) + " bytes to " + result.path);
+    return result;
+}
+
+json PwnDocClient::put_changes(const std::string& endpoint, const json& data) {
+    std::optional<json> cached = object_cache_.find(endpoint);
+    if (!cached || !cached->is_object() || !data.is_object() || data.empty()) {
+        return put(endpoint, data);
+    }
+
+    // The cached copy is the state last read or written by this server: reads
+    // store it, put_changes applies its own patch and every other write drops
+    // it, so no request is needed to diff against it
+    json patch = json::object();
+    json unchanged = json::array();
+    for (auto it = data.begin(); it != data.end(); ++it) {
+        auto current = cached->find(it.key());
+        if (current != cached->end() && *current == it.value()) {
+            unchanged.push_back(it.key());
+        } else {
+            patch[it.key()] = it.value();
+        }
+    }
+
+    size_t full_size = data.dump().size();
+    if (patch.empty()) {
+        log_debug("PUT " + endpoint + " skipped, no field changed");
+        return {
+            {"status", "success"},
+            {"datas", "No changes"},
+            {"skipped", true},
+            {"unchanged_fields", unchanged},
+            {"bytes_saved", full_size}
+        };
+    }
+
+    json result = put(endpoint, patch);
+
+    // The server now holds the cached object with the patch applied
+    cached->update(patch);
+    object_cache_.store(endpoint, *cached);
+
+    if (result.is_object() && !unchanged.empty()) {
+        result["unchanged_fields"] = unchanged;
+        result["bytes_saved"] = full_size - patch.dump().size();
+    }
+    return result;
 }
 
 json PwnDocClient::test_connection() {
@@ -0,0 +1,75 @@
+#include "coalescer.hpp"
+#include "client.hpp"
+#include <thread>
+
+using json = nlohmann::json;
+
+WriteCoalescer::WriteCoalescer(std::chrono::milliseconds window) : window_(window) {}
+
+json WriteCoalescer::submit(const std::string& key, const json& patch, const WriteFn& write) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& slot = keys_[key];
+    if (!slot) slot = std::make_shared<KeyState>();
+    std::shared_ptr<KeyState> state = slot;
+
+    // Follower: fold into the open batch and wait for its leader to write it
+    if (state->open) {
+        std::shared_ptr<Batch> batch = state->open;
+        batch->patch.update(patch);
+        ++batch->callers;
+        // A follower's own deadline still applies while the leader writes
+        if (auto deadline = RequestDeadline::current()) {
+            if (!batch->cv.wait_until(lock, *deadline, [&] { return batch->done; })) {
+                throw TimeoutError("Deadline exceeded waiting for a coalesced write of " + key +
+                                   "; the update may still be applied");
+            }
+        } else {
+            batch->cv.wait(lock, [&] { return batch->done; });
+        }
+        if (batch->error) std::rethrow_exception(batch->error);
+        return batch->result;
+    }
+
+    // Leader: open a batch, then write it once the previous write to this
+    // key is done. Followers join while it waits.
+    auto batch = std::make_shared<Batch>();
+    batch->patch = patch;
+    state->open = batch;
+    ++state->leaders;
+    lock.unlock();
+
+    if (window_.count() > 0) {
+        std::this_thread::sleep_for(window_);
+    }
+
+    std::lock_guard<std::mutex> serial(state->serial);
+    lock.lock();
+    state->open.reset();
+    json merged = batch->patch;
+    size_t callers = batch->callers;
+    lock.unlock();
+
+    json result;
+    std::exception_ptr error;
+    try {
+        result = write(merged);
+        if (result.is_object() && callers > 1) {
+            result["coalesced_updates"] = callers;
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    lock.lock();
+    batch->result = result;
+    batch->error = error;
+    batch->done = true;
+    if (--state->leaders == 0) {
+        keys_.erase(key);
+    }
+    lock.unlock();
+    batch->cv.notify_all();
+
+    if (error) std::rethrow_exception(error);
+    return result;
+}
@@ -1,4 +1,5 @@
 #include "config.hpp"
+#include <cctype>
 #include <cstdlib>
 #include <fstream>
 #include <nlohmann/json.hpp>
@@ -14,10 +15,20 @@
 using json = nlohmann::json;
 
 std::string Config::get_config_path() {
+    std::string dir = get_data_dir();
+    if (dir.empty()) return "";
+#ifdef _WIN32
+    return dir + "\\config.json";
+#else
+    return dir + "/config.json";
+#endif
+}
+
+std::string Config::get_data_dir() {
 #ifdef _WIN32
     char path[MAX_PATH];
     if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_PROFILE, NULL, 0, path))) {
-        return std::string(path) + "\\.pwndoc-mcp\\config.json";
+        return std::string(path) + "\\.pwndoc-mcp";
     }
     return "";
 #else
@@ -26,7 +37,16 @@ std::string Config::get_config_path() {
         struct passwd* pw = getpwuid(getuid());
         home = pw ? pw->pw_dir : "/tmp";
     }
-    return std::string(home) + "/.pwndoc-mcp/config.json";
+    return std::string(home) + "/.pwndoc-mcp";
+#endif
+}
+
+std::string Config::get_download_dir() const {
+    if (!download_dir.empty()) return download_dir;
+#ifdef _WIN32
+    return get_data_dir() + "\\downloads";
+#else
+    return get_data_dir() + "/downloads";
 #endif
 }
 
@@ -56,6 +76,46 @@ Config Config::from_env() {
     if (const char* timeout = std::getenv("PWNDOC_TIMEOUT")) {
         config.timeout = std::atoi(timeout);
     }
+
+    if (const char* concurrency = std::getenv("PWNDOC_MAX_CONCURRENCY")) {
+        config.max_concurrency = std::atoi(concurrency);
+    }
+
+    if (const char* window = std::getenv("PWNDOC_COALESCE_WINDOW_MS")) {
+        config.coalesce_window_ms = std::atoi(window);
+    }
+
+    if (const char* ttl = std::getenv("PWNDOC_CACHE_TTL")) {
+        config.cache_ttl = std::atoi(ttl);
+    }
+
+    if (const char* dir = std::getenv("PWNDOC_DOWNLOAD_DIR")) {
+        config.download_dir = dir;
+    }
+
+    if (const char* dedup = std::getenv("PWNDOC_IMAGE_DEDUP")) {
+        config.image_dedup = dedup;
+    }
+
+    if (const char* workers = std::getenv("PWNDOC_REPORT_WORKERS")) {
+        config.report_workers = std::atoi(workers);
+    }
+
+    if (const char* timeout = std::getenv("PWNDOC_REPORT_TIMEOUT")) {
+        config.report_timeout = std::atoi(timeout);
+    }
+
+    if (const char* size = std::getenv("PWNDOC_REPORT_CACHE_MB")) {
+        config.report_cache_mb = std::atoi(size);
+    }
+
+    if (const char* threshold = std::getenv("PWNDOC_SPILL_THRESHOLD_KB")) {
+        config.spill_threshold_kb = std::atoi(threshold);
+    }
+
+    if (const char* chars = std::getenv("PWNDOC_SUMMARY_TEXT_CHARS")) {
+        config.summary_text_chars = std::atoi(chars);
+    }
     
     return config;
 }
@@ -77,6 +137,16 @@ Config Config::from_file(const std::string& path) {
         if (data.contains("password")) config.password = data["password"].get<std::string>();
         if (data.contains("verify_ssl")) config.verify_ssl = data["verify_ssl"].get<bool>();
         if (data.contains("timeout")) config.timeout = data["timeout"].get<int>();
+        if (data.contains("max_concurrency")) config.max_concurrency = data["max_concurrency"].get<int>();
+        if (data.contains("coalesce_window_ms")) config.coalesce_window_ms = data["coalesce_window_ms"].get<int>();
+        if (data.contains("cache_ttl")) config.cache_ttl = data["cache_ttl"].get<int>();
+        if (data.contains("download_dir")) config.download_dir = data["download_dir"].get<std::string>();
+        if (data.contains("image_dedup")) config.image_dedup = data["image_dedup"].get<std::string>();
+        if (data.contains("report_workers")) config.report_workers = data["report_workers"].get<int>();
+        if (data.contains("report_timeout")) config.report_timeout = data["report_timeout"].get<int>();
+        if (data.contains("report_cache_mb")) config.report_cache_mb = data["report_cache_mb"].get<int>();
+        if (data.contains("spill_threshold_kb")) config.spill_threshold_kb = data["spill_threshold_kb"].get<int>();
+        if (data.contains("summary_text_chars")) config.summary_text_chars = data["summary_text_chars"].get<int>();
     } catch (const json::exception&) {
         // Invalid JSON, return empty config
     }
@@ -84,6 +154,40 @@ Config Config::from_file(const std::string& path) {
     return config;
 }
 
+Config Config::target(const std::string& name, Config base) {
+    base.url.clear();
+    base.token.reset();
+    base.username.reset();
+    base.password.reset();
+
+    std::ifstream file(get_config_path());
+    if (file.is_open()) {
+        try {
+            json data = json::parse(file);
+            if (data.contains("targets") && data["targets"].contains(name)) {
+                const json& entry = data["targets"][name];
+                if (entry.contains("url")) base.url = entry["url"].get<std::string>();
+                if (entry.contains("token")) base.token = entry["token"].get<std::string>();
+                if (entry.contains("username")) base.username = entry["username"].get<std::string>();
+                if (entry.contains("password")) base.password = entry["password"].get<std::string>();
+                if (entry.contains("verify_ssl")) base.verify_ssl = entry["verify_ssl"].get<bool>();
+            }
+        } catch (const json::exception&) {
+            // Invalid JSON: rely on the environment
+        }
+    }
+
+    std::string prefix = "PWNDOC_TARGET_";
+    for (char c : name) {
+        prefix += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : '_';
+    }
+    if (const char* url = std::getenv((prefix + "_URL").c_str())) base.url = url;
+    if (const char* token = std::getenv((prefix + "_TOKEN").c_str())) base.token = token;
+    if (const char* username = std::getenv((prefix + "_USERNAME").c_str())) base.username = username;
+    if (const char* password = std::getenv((prefix + "_PASSWORD").c_str())) base.password = password;
+    return base;
+}
+
 Config Config::load() {
     // Start with file config
     Config config = from_file(get_config_path());
@@ -99,6 +203,16 @@ Config Config::load() {
     // These are always overridden if set in env
     if (std::getenv("PWNDOC_VERIFY_SSL")) config.verify_ssl = env.verify_ssl;
     if (std::getenv("PWNDOC_TIMEOUT")) config.timeout = env.timeout;
+    if (std::getenv("PWNDOC_MAX_CONCURRENCY")) config.max_concurrency = env.max_concurrency;
+    if (std::getenv("PWNDOC_COALESCE_WINDOW_MS")) config.coalesce_window_ms = env.coalesce_window_ms;
+    if (std::getenv("PWNDOC_CACHE_TTL")) config.cache_ttl = env.cache_ttl;
+    if (std::getenv("PWNDOC_DOWNLOAD_DIR")) config.download_dir = env.download_dir;
+    if (std::getenv("PWNDOC_IMAGE_DEDUP")) config.image_dedup = env.image_dedup;
+    if (std::getenv("PWNDOC_REPORT_WORKERS")) config.report_workers = env.report_workers;
+    if (std::getenv("PWNDOC_REPORT_TIMEOUT")) config.report_timeout = env.report_timeout;
+    if (std::getenv("PWNDOC_REPORT_CACHE_MB")) config.report_cache_mb = env.report_cache_mb;
+    if (std::getenv("PWNDOC_SPILL_THRESHOLD_KB")) config.spill_threshold_kb = env.spill_threshold_kb;
+    if (std::getenv("PWNDOC_SUMMARY_TEXT_CHARS")) config.summary_text_chars = env.summary_text_chars;
     
     return config;
 }
@@ -113,6 +227,22 @@ std::vector<std::string> Config::validate() const {
     if (!token && !(username && password)) {
         errors.push_back("Either PWNDOC_TOKEN or PWNDOC_USERNAME/PWNDOC_PASSWORD required");
     }
+
+    if (max_concurrency < 1) {
+        errors.push_back("PWNDOC_MAX_CONCURRENCY must be at least 1");
+    }
+
+    if (report_workers < 1) {
+        errors.push_back("PWNDOC_REPORT_WORKERS must be at least 1");
+    }
+
+    if (summary_text_chars < 1) {
+        errors.push_back("PWNDOC_SUMMARY_TEXT_CHARS must be at least 1");
+    }
+
+    if (image_dedup != "audit" && image_dedup != "instance" && image_dedup != "off") {
+        errors.push_back("PWNDOC_IMAGE_DEDUP must be one of: audit, instance, off");
+    }
     
     return errors;
 }
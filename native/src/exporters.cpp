@@ -0,0 +1,329 @@
+#include "exporters.hpp"
+#include "parallel.hpp"
+#include "progress.hpp"
+#include <zlib.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Enrichment
+// ============================================================================
+
+namespace {
+
+// CVSS v3.1 specification, section 7.4
+double cvss_roundup(double value) {
+    long long scaled = std::llround(value * 100000.0);
+    if (scaled % 10000 == 0) return scaled / 100000.0;
+    return (std::floor(scaled / 10000.0) + 1.0) / 10.0;
+}
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+} // namespace
+
+std::optional<double> cvss3_base_score(const std::string& vector) {
+    std::map<std::string, std::string> metrics;
+    std::istringstream parts(vector);
+    std::string part;
+    while (std::getline(parts, part, '/')) {
+        size_t colon = part.find(':');
+        if (colon != std::string::npos) metrics[part.substr(0, colon)] = part.substr(colon + 1);
+    }
+
+    auto weight = [&](const char* metric, const std::map<std::string, double>& weights) -> std::optional<double> {
+        auto value = metrics.find(metric);
+        if (value == metrics.end()) return std::nullopt;
+        auto it = weights.find(value->second);
+        if (it == weights.end()) return std::nullopt;
+        return it->second;
+    };
+
+    auto scope = metrics.find("S");
+    if (scope == metrics.end() || (scope->second != "U" && scope->second != "C")) return std::nullopt;
+    bool changed = scope->second == "C";
+
+    auto av = weight("AV", {{"N", 0.85}, {"A", 0.62}, {"L", 0.55}, {"P", 0.2}});
+    auto ac = weight("AC", {{"L", 0.77}, {"H", 0.44}});
+    auto pr = weight("PR", {{"N", 0.85}, {"L", changed ? 0.68 : 0.62}, {"H", changed ? 0.5 : 0.27}});
+    auto ui = weight("UI", {{"N", 0.85}, {"R", 0.62}});
+    const std::map<std::string, double> cia = {{"H", 0.56}, {"L", 0.22}, {"N", 0.0}};
+    auto c = weight("C", cia);
+    auto i = weight("I", cia);
+    auto a = weight("A", cia);
+    if (!av || !ac || !pr || !ui || !c || !i || !a) return std::nullopt;
+
+    double iss = 1.0 - (1.0 - *c) * (1.0 - *i) * (1.0 - *a);
+    double impact = changed ? 7.52 * (iss - 0.029) - 3.25 * std::pow(iss - 0.02, 15) : 6.42 * iss;
+    double exploitability = 8.22 * *av * *ac * *pr * *ui;
+    if (impact <= 0.0) return 0.0;
+    return cvss_roundup(std::min((changed ? 1.08 : 1.0) * (impact + exploitability), 10.0));
+}
+
+std::string cvss3_severity(double score) {
+    if (score == 0.0) return "None";
+    if (score < 4.0) return "Low";
+    if (score < 7.0) return "Medium";
+    if (score < 9.0) return "High";
+    return "Critical";
+}
+
+std::string strip_html(const std::string& html) {
+    static const std::map<std::string, std::string> entities = {
+        {"amp", "&"}, {"lt", "<"}, {"gt", ">"}, {"quot", "\""}, {"apos", "'"}, {"#39", "'"}, {"nbsp", " "}
+    };
+    static const std::set<std::string> blocks = {
+        "p", "br", "div", "li", "tr", "pre", "h1", "h2", "h3", "h4", "h5", "h6", "ul", "ol", "table", "blockquote"
+    };
+
+    std::string text;
+    for (size_t pos = 0; pos < html.size(); ++pos) {
+        char c = html[pos];
+        if (c == '<') {
+            size_t end = html.find('>', pos);
+            if (end == std::string::npos) break;
+            size_t name_start = html.find_first_not_of("/ ", pos + 1);
+            size_t name_end = html.find_first_of(" />", name_start);
+            if (name_start < end && blocks.count(lowercase(html.substr(name_start, name_end - name_start)))) {
+                text += '\n';
+            }
+            pos = end;
+        } else if (c == '&') {
+            size_t end = html.find(';', pos);
+            auto it = end != std::string::npos && end - pos <= 6 ? entities.find(html.substr(pos + 1, end - pos - 1))
+                                                                  : entities.end();
+            if (it != entities.end()) {
+                text += it->second;
+                pos = end;
+            } else {
+                text += c;
+            }
+        } else {
+            text += c;
+        }
+    }
+
+    // Collapse runs of blanks; keep single line breaks between blocks
+    std::string out;
+    bool space = false, newline = false;
+    for (char c : text) {
+        if (c == '\n') {
+            newline = true;
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            space = true;
+        } else {
+            if (!out.empty()) {
+                if (newline) out += '\n';
+                else if (space) out += ' ';
+            }
+            out += c;
+            space = newline = false;
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> find_cwes(const json& value) {
+    std::vector<std::string> cwes;
+    auto add = [&](const std::string& digits) {
+        std::string id = "CWE-" + digits;
+        if (std::find(cwes.begin(), cwes.end(), id) == cwes.end()) cwes.push_back(id);
+    };
+    auto digits_at = [](const std::string& text, size_t pos) {
+        size_t end = pos;
+        while (end < text.size() && std::isdigit(static_cast<unsigned char>(text[end]))) ++end;
+        return text.substr(pos, end - pos);
+    };
+
+    std::function<void(const json&)> scan = [&](const json& item) {
+        if (item.is_structured()) {
+            for (const auto& child : item) scan(child);
+            return;
+        }
+        if (!item.is_string()) return;
+        std::string text = lowercase(item.get<std::string>());
+        for (size_t pos = 0; (pos = text.find("cwe", pos)) != std::string::npos; pos += 3) {
+            size_t start = pos + 3;
+            if (start < text.size() && (text[start] == '-' || text[start] == ' ' || text[start] == ':')) ++start;
+            std::string digits = digits_at(text, start);
+            if (!digits.empty()) add(digits);
+        }
+        for (size_t pos = 0; (pos = text.find("/definitions/", pos)) != std::string::npos; pos += 13) {
+            std::string digits = digits_at(text, pos + 13);
+            if (!digits.empty()) add(digits);
+        }
+    };
+    scan(value);
+    return cwes;
+}
+
+// ============================================================================
+// Findings export
+// ============================================================================
+
+namespace {
+
+constexpr size_t MAX_REPORTED_ERRORS = 100;
+
+const char* const HTML_FIELDS[] = {"description", "observation", "remediation", "poc"};
+
+/**
+ * Finding with plain-text HTML fields, CWE ids and CVSS severity
+ */
+void enrich_finding(json& finding) {
+    for (const char* field : HTML_FIELDS) {
+        auto it = finding.find(field);
+        if (it != finding.end() && it->is_string()) *it = strip_html(it->get<std::string>());
+    }
+
+    json sources = json::array();
+    for (const char* field : {"title", "description", "references", "cwe"}) {
+        if (finding.contains(field)) sources.push_back(finding[field]);
+    }
+    finding["cwe"] = find_cwes(sources);
+
+    std::optional<double> score;
+    if (finding.contains("cvssv3") && finding["cvssv3"].is_string()) {
+        score = cvss3_base_score(finding["cvssv3"].get<std::string>());
+    }
+    finding["cvss_score"] = score ? json(*score) : json();
+    finding["severity"] = score ? json(cvss3_severity(*score)) : json();
+}
+
+std::string default_export_name() {
+    std::time_t now = std::time(nullptr);
+    std::ostringstream oss;
+    oss << "pwndoc-findings-" << std::put_time(std::gmtime(&now), "%Y%m%d-%H%M%S") << ".ndjson";
+    return oss.str();
+}
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+json export_findings(PwnDocClient& client, const json& args) {
+    std::string path = args.value("output_path", "");
+    if (path.empty()) path = client.config().get_download_dir() + "/";
+    if (path.back() == '/' || path.back() == '\\' || fs::is_directory(path)) {
+        path = (fs::path(path) / default_export_name()).string();
+    }
+    bool enrich = args.value("enrich", false);
+    int limit = client.config().max_concurrency;
+    size_t max_parallel = static_cast<size_t>(std::clamp(args.value("max_parallel", limit), 1, limit));
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::pair<std::string, std::string>> audits;
+    if (args.contains("audit_ids")) {
+        for (const auto& id : args["audit_ids"]) audits.emplace_back(id.get<std::string>(), "");
+    } else {
+        json list = response_datas(client.get("/api/audits"));
+        if (list.is_array()) {
+            for (const auto& audit : list) {
+                if (audit.contains("_id")) audits.emplace_back(audit["_id"].get<std::string>(), audit.value("name", ""));
+            }
+        }
+    }
+
+    // Plain files go through zlib too, in transparent mode
+    fs::path parent = fs::path(path).parent_path();
+    if (!parent.empty()) fs::create_directories(parent);
+    std::string part = path + ".part";
+    gzFile file = gzopen(part.c_str(), ends_with(path, ".gz") ? "wb6" : "wbT");
+    if (!file) {
+        throw PwnDocError("Cannot write " + part);
+    }
+    gzbuffer(file, 256 * 1024);
+
+    std::mutex mutex;
+    size_t findings_written = 0, audits_done = 0;
+    uint64_t bytes = 0;
+    json errors = json::array();
+    size_t error_count = 0;
+    ProgressSink progress = ProgressScope::current();
+
+    // Only the audits in flight are held in memory; each one's findings
+    // are serialized, then written as one contiguous block
+    try {
+        parallel_for(audits.size(), max_parallel, [&](size_t i) {
+            const auto& [audit_id, listed_name] = audits[i];
+            std::string block;
+            size_t count = 0;
+            std::string error;
+            try {
+                json audit = response_datas(client.get("/api/audits/" + audit_id));
+                std::string name = audit.is_object() ? audit.value("name", listed_name) : listed_name;
+                json findings = audit.is_object() && audit.contains("findings") ? std::move(audit["findings"]) : json::array();
+                for (auto& finding : findings) {
+                    if (!finding.is_object()) continue;
+                    finding["audit_id"] = audit_id;
+                    finding["audit_name"] = name;
+                    if (enrich) enrich_finding(finding);
+                    block += finding.dump();
+                    block += '\n';
+                    ++count;
+                }
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error.empty()) {
+                ++error_count;
+                if (errors.size() < MAX_REPORTED_ERRORS) errors.push_back({{"audit_id", audit_id}, {"error", error}});
+            } else if (!block.empty()) {
+                if (gzwrite(file, block.data(), static_cast<unsigned>(block.size())) != static_cast<int>(block.size())) {
+                    int code = 0;
+                    throw PwnDocError(std::string("Failed writing export: ") + gzerror(file, &code));
+                }
+                bytes += block.size();
+                findings_written += count;
+            }
+            ++audits_done;
+            progress(static_cast<double>(audits_done), static_cast<double>(audits.size()),
+                     "Exported " + std::to_string(audits_done) + " of " + std::to_string(audits.size()) + " audits");
+        });
+    } catch (...) {
+        gzclose(file);
+        std::error_code ignored;
+        fs::remove(part, ignored);
+        throw;
+    }
+
+    if (gzclose(file) != Z_OK) {
+        fs::remove(part);
+        throw PwnDocError("Failed to finish export " + path);
+    }
+    fs::rename(part, path);
+
+    return {
+        {"path", fs::absolute(path).string()},
+        {"audits", audits.size()},
+        {"findings", findings_written},
+        {"bytes", fs::file_size(path)},
+        {"uncompressed_bytes", bytes},
+        {"enriched", enrich},
+        {"elapsed_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count()},
+        {"errors", errors},
+        {"error_count", error_count}
+    };
+}
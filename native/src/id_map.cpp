@@ -0,0 +1,67 @@
+#include "id_map.hpp"
+
+using json = nlohmann::json;
+
+bool is_object_id(const std::string& id) {
+    return id.size() == 24 && id.find_first_not_of("0123456789abcdef") == std::string::npos;
+}
+
+void collect_image_ids(const json& value, std::set<std::string>& ids) {
+    if (value.is_string()) {
+        const std::string& text = value.get_ref<const std::string&>();
+        size_t pos = 0;
+        while ((pos = text.find("<img", pos)) != std::string::npos) {
+            size_t tag_end = text.find('>', pos);
+            size_t src = text.find("src=\"", pos);
+            pos += 4;
+            if (src == std::string::npos || (tag_end != std::string::npos && src > tag_end)) continue;
+            src += 5;
+            size_t close = text.find('"', src);
+            if (close == std::string::npos) break;
+            std::string id = text.substr(src, close - src);
+            if (is_object_id(id)) ids.insert(id);
+        }
+    } else if (value.is_structured()) {
+        for (const auto& item : value) collect_image_ids(item, ids);
+    }
+}
+
+void IdMap::put(const std::string& old_id, const std::string& new_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ids_[old_id] = new_id;
+}
+
+std::string IdMap::get(const std::string& old_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(old_id);
+    return it == ids_.end() ? std::string() : it->second;
+}
+
+size_t IdMap::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ids_.size();
+}
+
+void IdMap::remap(json& value) const {
+    if (value.is_string()) {
+        std::string& text = value.get_ref<std::string&>();
+        if (is_object_id(text)) {
+            std::string mapped = get(text);
+            if (!mapped.empty()) text = mapped;
+            return;
+        }
+        size_t pos = 0;
+        while ((pos = text.find("<img", pos)) != std::string::npos) {
+            size_t tag_end = text.find('>', pos);
+            size_t src = text.find("src=\"", pos);
+            pos += 4;
+            if (src == std::string::npos || (tag_end != std::string::npos && src > tag_end)) continue;
+            src += 5;
+            if (src + 24 > text.size() || text[src + 24] != '"') continue;
+            std::string mapped = get(text.substr(src, 24));
+            if (!mapped.empty()) text.replace(src, 24, mapped);
+        }
+    } else if (value.is_structured()) {
+        for (auto& item : value) remap(item);
+    }
+}
@@ -0,0 +1,106 @@
+#include "image_index.hpp"
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+ImageIndex::ImageIndex(std::string path, std::string instance, Scope scope)
+    : path_(std::move(path)), instance_(std::move(instance)), scope_(scope) {}
+
+ImageIndex::Scope ImageIndex::parse_scope(const std::string& name) {
+    if (name == "instance") return Scope::Instance;
+    if (name == "off") return Scope::Off;
+    return Scope::Audit;
+}
+
+std::string ImageIndex::key(const std::string& audit_id, const std::string& sha256) const {
+    return instance_ + " " + (scope_ == Scope::Instance ? std::string("*") : audit_id) + ":" + sha256;
+}
+
+bool ImageIndex::own(const std::string& key) const {
+    return key.size() > instance_.size() && key.compare(0, instance_.size(), instance_) == 0 &&
+           key[instance_.size()] == ' ';
+}
+
+std::optional<std::string> ImageIndex::find(const std::string& audit_id, const std::string& sha256) {
+    if (!enabled()) return std::nullopt;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+    auto it = entries_.find(key(audit_id, sha256));
+    if (it == entries_.end()) return std::nullopt;
+    return it->second.image_id;
+}
+
+void ImageIndex::store(const std::string& audit_id, const std::string& sha256, const std::string& image_id) {
+    if (!enabled()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+    entries_[key(audit_id, sha256)] = {image_id, audit_id};
+    save();
+}
+
+void ImageIndex::remove_image(const std::string& image_id) {
+    if (!enabled()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+    size_t before = entries_.size();
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        it = own(it->first) && it->second.image_id == image_id ? entries_.erase(it) : std::next(it);
+    }
+    if (entries_.size() != before) save();
+}
+
+void ImageIndex::remove_audit(const std::string& audit_id) {
+    if (!enabled()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+    size_t before = entries_.size();
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        it = own(it->first) && it->second.audit_id == audit_id ? entries_.erase(it) : std::next(it);
+    }
+    if (entries_.size() != before) save();
+}
+
+void ImageIndex::load() {
+    if (loaded_) return;
+    loaded_ = true;
+    if (path_.empty()) return;
+
+    std::ifstream file(path_);
+    if (!file.is_open()) return;
+    try {
+        json data = json::parse(file);
+        for (const auto& [k, entry] : data.items()) {
+            entries_[k] = {entry.value("image_id", ""), entry.value("audit_id", "")};
+        }
+    } catch (const json::exception&) {
+        // Corrupt index: start over rather than failing uploads
+        entries_.clear();
+    }
+}
+
+void ImageIndex::save() {
+    if (path_.empty()) return;
+
+    json data = json::object();
+    for (const auto& [k, entry] : entries_) {
+        data[k] = {{"image_id", entry.image_id}, {"audit_id", entry.audit_id}};
+    }
+
+    // Write a temporary file and rename it so a crash never truncates the index
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path_).parent_path(), ec);
+    std::string temp = path_ + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        if (!file.is_open()) return;
+        file << data.dump();
+        if (!file) return;
+    }
+    std::filesystem::rename(temp, path_, ec);
+}
@@ -0,0 +1,1342 @@
+#include "importers.hpp"
+#include "bulk.hpp"
+#include "parallel.hpp"
+#include "progress.hpp"
+#include "sha256.hpp"
+#include "xml_stream.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+using Event = XmlReader::Event;
+
+std::ifstream open_input(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    return in;
+}
+
+std::string file_stem(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+/**
+ * Read one <port> element; returns null if the port is filtered out
+ */
+json read_nmap_port(XmlReader& xml, const NmapImportOptions& options) {
+    json service = {
+        {"port", std::atoi(xml.attribute("portid", "0").c_str())},
+        {"protocol", xml.attribute("protocol", "tcp")},
+        {"name", ""},
+        {"product", ""},
+        {"version", ""}
+    };
+    std::string state;
+
+    size_t depth = xml.depth();
+    while (xml.depth() >= depth) {
+        Event event = xml.next();
+        if (event == Event::EndDocument) break;
+        if (event != Event::StartElement) continue;
+
+        if (xml.name() == "state") {
+            state = xml.attribute("state");
+        } else if (xml.name() == "service") {
+            service["name"] = xml.attribute("name");
+            service["product"] = xml.attribute("product");
+            service["version"] = xml.attribute("version");
+        }
+    }
+
+    // PwnDoc only models TCP and UDP services
+    std::string protocol = service["protocol"];
+    if (protocol != "tcp" && protocol != "udp") return nullptr;
+    if (!options.include_closed && state != "open") return nullptr;
+    return service;
+}
+
+/**
+ * Read one <host> element; returns null if the host is filtered out
+ */
+json read_nmap_host(XmlReader& xml, const NmapImportOptions& options, NmapImportStats& stats) {
+    json host = {
+        {"hostname", ""},
+        {"ip", ""},
+        {"os", ""},
+        {"services", json::array()}
+    };
+    bool up = true;
+    bool user_hostname = false;
+    int os_accuracy = -1;
+
+    size_t depth = xml.depth();
+    while (xml.depth() >= depth) {
+        Event event = xml.next();
+        if (event == Event::EndDocument) break;
+        if (event != Event::StartElement) continue;
+
+        const std::string& name = xml.name();
+        if (name == "status") {
+            up = xml.attribute("state") == "up";
+        } else if (name == "address") {
+            // Prefer IPv4 over IPv6; MAC addresses are not part of the scope
+            std::string type = xml.attribute("addrtype");
+            if (type == "ipv4" || (type == "ipv6" && host["ip"] == "")) {
+                host["ip"] = xml.attribute("addr");
+            }
+        } else if (name == "hostname") {
+            // Names given on the command line win over reverse lookups
+            bool user = xml.attribute("type") == "user";
+            if (host["hostname"] == "" || (user && !user_hostname)) {
+                host["hostname"] = xml.attribute("name");
+                user_hostname = user;
+            }
+        } else if (name == "osmatch") {
+            int accuracy = std::atoi(xml.attribute("accuracy", "0").c_str());
+            if (accuracy > os_accuracy) {
+                host["os"] = xml.attribute("name");
+                os_accuracy = accuracy;
+            }
+        } else if (name == "port") {
+            json service = read_nmap_port(xml, options);
+            if (service.is_null()) {
+                ++stats.ports_skipped;
+            } else {
+                host["services"].push_back(std::move(service));
+            }
+        }
+    }
+
+    if (!up && !options.include_down) return nullptr;
+    return host;
+}
+
+} // namespace
+
+void read_nmap_hosts(std::istream& in, const NmapImportOptions& options,
+                     const std::function<void(const json& host)>& on_host,
+                     NmapImportStats& stats) {
+    XmlReader xml(in);
+    bool seen_root = false;
+
+    while (true) {
+        Event event = xml.next();
+        if (event == Event::EndDocument) break;
+        if (event != Event::StartElement) continue;
+
+        if (!seen_root) {
+            if (xml.name() != "nmaprun") {
+                throw std::runtime_error("Not an Nmap XML report (root element <" + xml.name() + ">)");
+            }
+            seen_root = true;
+            continue;
+        }
+
+        if (xml.name() != "host") continue;
+        json host = read_nmap_host(xml, options, stats);
+        if (host.is_null()) {
+            ++stats.hosts_skipped;
+            continue;
+        }
+        ++stats.hosts;
+        stats.services += host["services"].size();
+        on_host(host);
+    }
+
+    if (!seen_root) {
+        throw std::runtime_error("Not an Nmap XML report (no root element)");
+    }
+    stats.bytes_read = xml.bytes_read();
+}
+
+json import_nmap(PwnDocClient& client, const json& args) {
+    std::string audit_id = args["audit_id"].get<std::string>();
+    std::string path = args["file_path"].get<std::string>();
+    std::string scope_name = args.value("scope_name", file_stem(path));
+
+    NmapImportOptions options;
+    options.include_closed = args.value("include_closed", false);
+    options.include_down = args.value("include_down", false);
+
+    // Keep the other scopes of the audit; a scope with the same name is replaced
+    std::string endpoint = "/api/audits/" + audit_id + "/network";
+    auto start = std::chrono::steady_clock::now();
+    json kept = json::array();
+    bool replaced = false;
+    if (!args.value("replace_all", false)) {
+        json current = response_datas(client.get(endpoint));
+        if (current.is_object() && current.contains("scope") && current["scope"].is_array()) {
+            for (const auto& entry : current["scope"]) {
+                if (entry.value("name", "") == scope_name) {
+                    replaced = true;
+                } else {
+                    kept.push_back(entry);
+                }
+            }
+        }
+    }
+
+    // Hosts are serialized to an anonymous temporary file as they are
+    // parsed, and the request body is read back from it while it is sent,
+    // so memory stays bounded by a single host however large the report
+    UploadSource body;
+    body.head = "{\"scope\":[";
+    for (const auto& entry : kept) {
+        body.head += entry.dump();
+        body.head += ',';
+    }
+    body.head += json{{"name", scope_name}}.dump();
+    body.head.pop_back();
+    body.head += ",\"hosts\":[";
+    body.tail = "]}]}";
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> spool(std::tmpfile(), &std::fclose);
+    if (!spool) {
+        throw std::runtime_error("Cannot create a temporary file for the import");
+    }
+    body.file = spool.get();
+
+    NmapImportStats stats;
+    std::ifstream in = open_input(path);
+    read_nmap_hosts(in, options, [&](const json& host) {
+        std::string text = stats.hosts > 1 ? "," + host.dump() : host.dump();
+        if (std::fwrite(text.data(), 1, text.size(), body.file) != text.size()) {
+            throw std::runtime_error("Cannot write the temporary import file");
+        }
+    }, stats);
+    if (std::fflush(body.file) != 0) {
+        throw std::runtime_error("Cannot write the temporary import file");
+    }
+
+    client.put_stream(endpoint, body);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    return {
+        {"audit_id", audit_id},
+        {"scope_name", scope_name},
+        {"replaced_scope", replaced},
+        {"scopes", kept.size() + 1},
+        {"hosts", stats.hosts},
+        {"services", stats.services},
+        {"hosts_skipped", stats.hosts_skipped},
+        {"ports_skipped", stats.ports_skipped},
+        {"bytes_read", stats.bytes_read},
+        {"elapsed_ms", elapsed.count()}
+    };
+}
+
+// ============================================================================
+// Scanner reports (Nessus, Burp)
+// ============================================================================
+
+namespace {
+
+/**
+ * Issues of one plugin (Nessus) or issue type (Burp), merged across hosts
+ */
+struct IssueGroup {
+    std::string key;
+    std::string title;
+    int severity = 0;                      // 0 = info ... 4 = critical
+    std::string description;               // HTML
+    std::string remediation;               // HTML
+    std::vector<std::string> references;
+    std::string cvss;
+    std::string poc;                       // HTML evidence of the first occurrence
+    std::vector<std::string> affected;     // unique, in order of appearance
+    std::set<std::string> affected_seen;
+    size_t issues = 0;
+};
+
+class IssueGroups {
+public:
+    void add(IssueGroup&& issue, const std::string& affected) {
+        auto it = index_.find(issue.key);
+        if (it == index_.end()) {
+            it = index_.emplace(issue.key, groups_.size()).first;
+            groups_.push_back(std::move(issue));
+        }
+        IssueGroup& group = groups_[it->second];
+        ++group.issues;
+        if (!affected.empty() && group.affected_seen.insert(affected).second) {
+            group.affected.push_back(affected);
+        }
+    }
+
+    std::vector<IssueGroup>& groups() { return groups_; }
+
+private:
+    std::map<std::string, size_t> index_;
+    std::vector<IssueGroup> groups_;
+};
+
+// Evidence kept per group; scanner output can be megabytes per plugin
+constexpr size_t MAX_POC_BYTES = 8 * 1024;
+
+std::string escape_html(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out += c;
+        }
+    }
+    return out;
+}
+
+/**
+ * Plain scanner text to HTML paragraphs (blank lines separate paragraphs)
+ */
+std::string text_to_html(const std::string& text) {
+    std::string html;
+    std::string paragraph;
+    std::istringstream lines(text);
+    std::string line;
+    auto flush = [&] {
+        if (!paragraph.empty()) html += "<p>" + paragraph + "</p>";
+        paragraph.clear();
+    };
+    while (std::getline(lines, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            flush();
+            continue;
+        }
+        if (!paragraph.empty()) paragraph += "<br>";
+        paragraph += escape_html(line.substr(first));
+    }
+    flush();
+    return html;
+}
+
+std::string truncate_poc(const std::string& html) {
+    if (html.size() <= MAX_POC_BYTES) return html;
+    return html.substr(0, MAX_POC_BYTES) + "<p>[truncated]</p>";
+}
+
+/**
+ * Lowercase alphanumeric words separated by single spaces
+ */
+std::string normalize_title(const std::string& title) {
+    std::string out;
+    bool space = false;
+    for (unsigned char c : title) {
+        if (std::isalnum(c)) {
+            if (space && !out.empty()) out += ' ';
+            out += static_cast<char>(std::tolower(c));
+            space = false;
+        } else {
+            space = true;
+        }
+    }
+    return out;
+}
+
+void read_nessus_item(XmlReader& xml, const std::string& host, IssueGroups& groups) {
+    IssueGroup issue;
+    issue.key = "nessus:" + xml.attribute("pluginID");
+    issue.title = xml.attribute("pluginName");
+    issue.severity = std::atoi(xml.attribute("severity", "0").c_str());
+
+    std::string port = xml.attribute("port", "0");
+    std::string affected = host;
+    if (port != "0") affected += ":" + port + "/" + xml.attribute("protocol", "tcp");
+
+    std::string synopsis;
+    std::string description;
+    size_t depth = xml.depth();
+    while (xml.depth() >= depth) {
+        Event event = xml.next();
+        if (event == Event::EndDocument) break;
+        if (event != Event::StartElement) continue;
+
+        const std::string& name = xml.name();
+        if (name == "synopsis") {
+            synopsis = xml.read_text();
+        } else if (name == "description") {
+            description = xml.read_text();
+        } else if (name == "solution") {
+            issue.remediation = text_to_html(xml.read_text());
+        } else if (name == "see_also") {
+            std::istringstream links(xml.read_text());
+            std::string link;
+            while (std::getline(links, link)) {
+                if (!link.empty()) issue.references.push_back(link);
+            }
+        } else if (name == "cve") {
+            issue.references.push_back(xml.read_text());
+        } else if (name == "cvss3_vector") {
+            issue.cvss = xml.read_text();
+            if (issue.cvss.rfind("CVSS:", 0) != 0) issue.cvss = "CVSS:3.0/" + issue.cvss;
+        } else if (name == "plugin_output") {
+            issue.poc = truncate_poc("<pre>" + escape_html(xml.read_text()) + "</pre>");
+        } else {
+            xml.skip_element();
+        }
+    }
+
+    issue.description = text_to_html(synopsis.empty() ? description : synopsis + "\n\n" + description);
+    groups.add(std::move(issue), affected);
+}
+
+int burp_severity(const std::string& severity) {
+    if (severity == "High") return 3;
+    if (severity == "Medium") return 2;
+    if (severity == "Low") return 1;
+    return 0;
+}
+
+/**
+ * Link targets of a Burp HTML reference list
+ */
+std::vector<std::string> html_links(const std::string& html) {
+    std::vector<std::string> links;
+    size_t pos = 0;
+    while ((pos = html.find("href=\"", pos)) != std::string::npos) {
+        pos += 6;
+        size_t end = html.find('"', pos);
+        if (end == std::string::npos) break;
+        links.push_back(html.substr(pos, end - pos));
+        pos = end;
+    }
+    return links;
+}
+
+void read_burp_issue(XmlReader& xml, IssueGroups& groups) {
+    IssueGroup issue;
+    std::string host;
+    std::string path;
+    std::string type;
+    std::string detail;
+
+    size_t depth = xml.depth();
+    while (xml.depth() >= depth) {
+        Event event = xml.next();
+        if (event == Event::EndDocument) break;
+        if (event != Event::StartElement) continue;
+
+        const std::string& name = xml.name();
+        if (name == "type") {
+            type = xml.read_text();
+        } else if (name == "name") {
+            issue.title = xml.read_text();
+        } else if (name == "host") {
+            host = xml.read_text();
+        } else if (name == "path") {
+            path = xml.read_text();
+        } else if (name == "severity") {
+            issue.severity = burp_severity(xml.read_text());
+        } else if (name == "issueBackground") {
+            issue.description = xml.read_text();
+        } else if (name == "remediationBackground") {
+            issue.remediation = xml.read_text();
+        } else if (name == "references" || name == "vulnerabilityClassifications") {
+            for (auto& link : html_links(xml.read_text())) issue.references.push_back(std::move(link));
+        } else if (name == "issueDetail") {
+            detail = xml.read_text();
+        } else {
+            // Skips requestresponse, whose base64 payloads dominate the file
+            xml.skip_element();
+        }
+    }
+
+    issue.key = "burp:" + (type.empty() ? issue.title : type);
+    if (!detail.empty()) issue.poc = truncate_poc(detail);
+    groups.add(std::move(issue), host + path);
+}
+
+/**
+ * Vulnerability templates indexed by normalized title in every locale
+ */
+class TemplateIndex {
+public:
+    explicit TemplateIndex(const json& vulnerabilities) {
+        if (!vulnerabilities.is_array()) return;
+        for (const auto& vulnerability : vulnerabilities) {
+            if (!vulnerability.contains("details") || !vulnerability["details"].is_array()) continue;
+            for (const auto& detail : vulnerability["details"]) {
+                std::string title = normalize_title(detail.value("title", ""));
+                if (!title.empty()) by_title_.emplace(title, &vulnerability);
+            }
+        }
+    }
+
+    const json* find(const std::string& title) const {
+        auto it = by_title_.find(normalize_title(title));
+        return it == by_title_.end() ? nullptr : it->second;
+    }
+
+private:
+    std::unordered_map<std::string, const json*> by_title_;
+};
+
+std::string affected_html(const std::vector<std::string>& affected) {
+    std::string html = "<ul>";
+    for (const auto& item : affected) html += "<li>" + escape_html(item) + "</li>";
+    return html + "</ul>";
+}
+
+json finding_from_template(const json& vulnerability, const std::string& language, const IssueGroup& group) {
+    const json& details = vulnerability["details"];
+    const json* detail = &details[0];
+    for (const auto& candidate : details) {
+        if (candidate.value("locale", "") == language) {
+            detail = &candidate;
+            break;
+        }
+    }
+
+    json finding = {
+        {"title", detail->value("title", group.title)},
+        {"scope", affected_html(group.affected)},
+        {"poc", group.poc}
+    };
+    for (const char* key : {"vulnType", "description", "observation", "remediation", "references", "customFields"}) {
+        if (detail->contains(key) && !(*detail)[key].is_null()) finding[key] = (*detail)[key];
+    }
+    for (const char* key : {"cvssv3", "priority", "remediationComplexity", "category"}) {
+        if (vulnerability.contains(key) && !vulnerability[key].is_null()) finding[key] = vulnerability[key];
+    }
+    return finding;
+}
+
+json finding_from_scanner(const IssueGroup& group) {
+    json finding = {
+        {"title", group.title},
+        {"description", group.description},
+        {"remediation", group.remediation},
+        {"references", group.references},
+        {"scope", affected_html(group.affected)},
+        {"poc", group.poc},
+        // PwnDoc priority: 1 = low ... 4 = urgent
+        {"priority", std::clamp(group.severity, 1, 4)}
+    };
+    if (!group.cvss.empty()) finding["cvssv3"] = group.cvss;
+    return finding;
+}
+
+int parse_min_severity(const json& value) {
+    if (value.is_number_integer()) return value.get<int>();
+    static const std::map<std::string, int> names = {
+        {"info", 0}, {"low", 1}, {"medium", 2}, {"high", 3}, {"critical", 4}
+    };
+    auto it = names.find(value.get<std::string>());
+    if (it == names.end()) {
+        throw std::runtime_error("min_severity must be one of info, low, medium, high, critical");
+    }
+    return it->second;
+}
+
+} // namespace
+
+json import_scanner_report(PwnDocClient& client, const json& args) {
+    std::string audit_id = args["audit_id"].get<std::string>();
+    std::string path = args["file_path"].get<std::string>();
+    std::string format = args.value("format", "auto");
+    int min_severity = parse_min_severity(args.value("min_severity", json("low")));
+    bool create_unmatched = args.value("unmatched", "create") == "create";
+    bool dry_run = args.value("dry_run", false);
+    int limit = client.config().max_concurrency;
+    size_t max_parallel = static_cast<size_t>(std::clamp(args.value("max_parallel", limit), 1, limit));
+
+    // Parsing is reported as the first half of the work, creation as the second
+    ProgressSink progress = ProgressScope::current();
+    auto start = std::chrono::steady_clock::now();
+
+    std::ifstream in = open_input(path);
+    in.seekg(0, std::ios::end);
+    double file_size = static_cast<double>(in.tellg());
+    in.seekg(0, std::ios::beg);
+
+    XmlReader xml(in);
+    IssueGroups groups;
+    std::string host;
+    size_t issues = 0;
+    while (true) {
+        Event event = xml.next();
+        if (event == Event::EndDocument) break;
+        if (event != Event::StartElement) continue;
+
+        const std::string& name = xml.name();
+        if (format == "auto") {
+            if (name == "NessusClientData_v2") format = "nessus";
+            else if (name == "issues") format = "burp";
+            else throw std::runtime_error("Unrecognized report format (root element <" + name + ">)");
+            continue;
+        }
+
+        if (format == "nessus" && name == "ReportHost") {
+            host = xml.attribute("name");
+            continue;
+        } else if (format == "nessus" && name == "ReportItem") {
+            read_nessus_item(xml, host, groups);
+            ++issues;
+        } else if (format == "burp" && name == "issue") {
+            read_burp_issue(xml, groups);
+            ++issues;
+        } else {
+            continue;
+        }
+
+        if (issues % 500 == 0 && file_size > 0) {
+            progress(50.0 * xml.bytes_read() / file_size, 100.0,
+                     "Parsed " + std::to_string(issues) + " issues");
+        }
+    }
+    if (format != "nessus" && format != "burp") {
+        throw std::runtime_error("format must be auto, nessus or burp");
+    }
+    progress(50.0, 100.0, "Parsed " + std::to_string(issues) + " issues into " +
+                          std::to_string(groups.groups().size()) + " groups");
+
+    // Most severe first, then by title, matching how reports are usually ordered
+    auto& all = groups.groups();
+    std::stable_sort(all.begin(), all.end(), [](const IssueGroup& a, const IssueGroup& b) {
+        if (a.severity != b.severity) return a.severity > b.severity;
+        return a.title < b.title;
+    });
+
+    json vulnerabilities = response_datas(client.get("/api/vulnerabilities"));
+    TemplateIndex templates(vulnerabilities);
+    std::string language = response_datas(client.get("/api/audits/" + audit_id + "/general")).value("language", "");
+
+    std::set<std::string> existing_titles;
+    for (const auto& finding : response_datas(client.get("/api/audits/" + audit_id + "/findings"))) {
+        existing_titles.insert(normalize_title(finding.value("title", "")));
+    }
+
+    json findings = json::array();
+    json planned = json::array();
+    json skipped = json::array();
+    size_t matched = 0;
+    for (const auto& group : all) {
+        json entry = {
+            {"key", group.key},
+            {"scanner_title", group.title},
+            {"severity", group.severity},
+            {"issues", group.issues},
+            {"affected", group.affected.size()}
+        };
+        auto skip = [&](const std::string& reason) {
+            entry["reason"] = reason;
+            skipped.push_back(entry);
+        };
+
+        if (group.severity < min_severity) {
+            skip("below min_severity");
+            continue;
+        }
+        const json* vulnerability = templates.find(group.title);
+        if (!vulnerability && !create_unmatched) {
+            skip("no matching vulnerability template");
+            continue;
+        }
+        json finding = vulnerability ? finding_from_template(*vulnerability, language, group)
+                                     : finding_from_scanner(group);
+        if (existing_titles.count(normalize_title(finding["title"].get<std::string>()))) {
+            skip("finding already exists in audit");
+            continue;
+        }
+
+        if (vulnerability) {
+            ++matched;
+            entry["template_id"] = vulnerability->value("_id", "");
+        }
+        entry["title"] = finding["title"];
+        planned.push_back(entry);
+        findings.push_back(std::move(finding));
+    }
+
+    json result = {
+        {"audit_id", audit_id},
+        {"format", format},
+        {"issues", issues},
+        {"groups", all.size()},
+        {"matched_templates", matched},
+        {"skipped", skipped}
+    };
+
+    if (dry_run) {
+        result["planned"] = planned;
+    } else {
+        ProgressSink creation = [&progress](double done, double total, const std::string& message) {
+            progress(50.0 + 50.0 * done / total, 100.0, message);
+        };
+        json created = create_findings(client, audit_id, findings, args.value("sort", true),
+                                       max_parallel, creation);
+        for (size_t i = 0; i < planned.size(); ++i) {
+            planned[i].update(created["items"][i]);
+        }
+        result["items"] = planned;
+        result["sorted"] = created["sorted"];
+        result["summary"] = created["summary"];
+    }
+
+    result["elapsed_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Vulnerability templates (CSV, NDJSON)
+// ============================================================================
+
+namespace {
+
+// Rows validated and written per pipeline round; bounds memory for large files
+constexpr size_t IMPORT_CHUNK_ROWS = 500;
+
+// Validation errors listed in the result; the rest are only counted
+constexpr size_t MAX_REPORTED_ERRORS = 100;
+
+/**
+ * RFC 4180 CSV reader: quoted fields may contain commas, quotes ("") and
+ * line breaks
+ */
+class CsvReader {
+public:
+    explicit CsvReader(std::istream& in) : buf_(in.rdbuf()) {}
+
+    /**
+     * Read the next record; returns false at end of input
+     */
+    bool read_row(std::vector<std::string>& fields) {
+        fields.clear();
+        std::string field;
+        bool quoted = false;
+        bool started = false;
+        while (true) {
+            int c = buf_->sbumpc();
+            if (c == EOF) {
+                if (!started) return false;
+                fields.push_back(std::move(field));
+                return true;
+            }
+            ++bytes_;
+            started = true;
+
+            if (quoted) {
+                if (c != '"') {
+                    field += static_cast<char>(c);
+                } else if (buf_->sgetc() == '"') {
+                    buf_->sbumpc();
+                    ++bytes_;
+                    field += '"';
+                } else {
+                    quoted = false;
+                }
+            } else if (c == '"' && field.empty()) {
+                quoted = true;
+            } else if (c == ',') {
+                fields.push_back(std::move(field));
+                field.clear();
+            } else if (c == '\n') {
+                fields.push_back(std::move(field));
+                return true;
+            } else if (c != '\r') {
+                field += static_cast<char>(c);
+            }
+        }
+    }
+
+    size_t bytes_read() const { return bytes_; }
+
+private:
+    std::streambuf* buf_;
+    size_t bytes_ = 0;
+};
+
+int parse_level(const json& value, const char* field, int max) {
+    int level = 0;
+    if (value.is_number_integer()) {
+        level = value.get<int>();
+    } else if (value.is_string()) {
+        level = std::atoi(value.get<std::string>().c_str());
+    }
+    if (level < 1 || level > max) {
+        throw std::runtime_error(std::string(field) + " must be between 1 and " + std::to_string(max));
+    }
+    return level;
+}
+
+json parse_references(const json& value) {
+    if (value.is_array()) return value;
+    json references = json::array();
+    std::string text = value.is_string() ? value.get<std::string>() : value.dump();
+    std::string reference;
+    std::istringstream lines(text);
+    // CSV cells separate references with newlines or '|'
+    while (std::getline(lines, reference)) {
+        std::istringstream parts(reference);
+        std::string part;
+        while (std::getline(parts, part, '|')) {
+            size_t first = part.find_first_not_of(" \t\r");
+            if (first != std::string::npos) {
+                references.push_back(part.substr(first, part.find_last_not_of(" \t\r") - first + 1));
+            }
+        }
+    }
+    return references;
+}
+
+/**
+ * Validate a row and convert it to a PwnDoc vulnerability. Rows either use
+ * the API shape ({..., details: [{locale, title, ...}]}) or a flat shape
+ * with one locale per row (title, locale, description, ...).
+ */
+json to_vulnerability(const json& row, const std::string& default_locale) {
+    if (!row.is_object()) throw std::runtime_error("row is not an object");
+
+    json vulnerability = json::object();
+    if (row.contains("details")) {
+        if (!row["details"].is_array() || row["details"].empty()) {
+            throw std::runtime_error("details must be a non-empty array");
+        }
+        vulnerability = row;
+        for (auto& detail : vulnerability["details"]) {
+            if (!detail.is_object() || !detail.contains("title") || !detail["title"].is_string() ||
+                detail["title"].get<std::string>().empty()) {
+                throw std::runtime_error("every detail requires a title");
+            }
+            if (!detail.contains("locale")) detail["locale"] = default_locale;
+            if (detail.contains("references")) detail["references"] = parse_references(detail["references"]);
+        }
+    } else {
+        std::string title = row.value("title", "");
+        if (title.empty()) throw std::runtime_error("title is required");
+
+        json detail = {{"locale", row.value("locale", default_locale)}, {"title", title}};
+        for (const char* key : {"vulnType", "description", "observation", "remediation"}) {
+            if (row.contains(key)) detail[key] = row[key];
+        }
+        if (row.contains("references")) detail["references"] = parse_references(row["references"]);
+        vulnerability["details"] = json::array({detail});
+        for (const char* key : {"cvssv3", "category", "priority", "remediationComplexity"}) {
+            if (row.contains(key)) vulnerability[key] = row[key];
+        }
+    }
+
+    if (vulnerability.contains("priority")) {
+        vulnerability["priority"] = parse_level(vulnerability["priority"], "priority", 4);
+    }
+    if (vulnerability.contains("remediationComplexity")) {
+        vulnerability["remediationComplexity"] =
+            parse_level(vulnerability["remediationComplexity"], "remediationComplexity", 3);
+    }
+    if (vulnerability.contains("cvssv3")) {
+        const json& cvss = vulnerability["cvssv3"];
+        if (!cvss.is_string() || (!cvss.get<std::string>().empty() && cvss.get<std::string>().rfind("CVSS:3", 0) != 0)) {
+            throw std::runtime_error("cvssv3 must be a CVSS:3.x vector");
+        }
+    }
+    return vulnerability;
+}
+
+/**
+ * Apply an imported vulnerability on top of an existing one: imported
+ * locales replace the existing detail of the same locale, others are kept
+ */
+json merge_vulnerability(const json& existing, const json& imported) {
+    json merged = imported;
+    merged.erase("_id");
+    json details = existing.value("details", json::array());
+    for (const auto& detail : imported["details"]) {
+        bool replaced = false;
+        for (auto& current : details) {
+            if (current.value("locale", "") == detail.value("locale", "")) {
+                current = detail;
+                replaced = true;
+            }
+        }
+        if (!replaced) details.push_back(detail);
+    }
+    merged["details"] = details;
+    return merged;
+}
+
+struct ImportRow {
+    size_t line = 0;
+    json vulnerability;
+    const json* existing = nullptr;
+};
+
+} // namespace
+
+json import_vulnerabilities(PwnDocClient& client, const json& args) {
+    std::string path = args["file_path"].get<std::string>();
+    std::string format = args.value("format", "");
+    if (format.empty()) {
+        bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        format = csv ? "csv" : "ndjson";
+    }
+    if (format != "csv" && format != "ndjson") {
+        throw std::runtime_error("format must be csv or ndjson");
+    }
+    std::string locale = args.value("locale", "en");
+    bool update_existing = args.value("on_existing", "update") == "update";
+    bool dry_run = args.value("dry_run", false);
+    size_t batch_size = static_cast<size_t>(std::max(1, args.value("batch_size", 50)));
+    int limit = client.config().max_concurrency;
+    size_t max_parallel = static_cast<size_t>(std::clamp(args.value("max_parallel", limit), 1, limit));
+
+    ProgressSink progress = ProgressScope::current();
+    auto start = std::chrono::steady_clock::now();
+
+    std::ifstream in = open_input(path);
+    in.seekg(0, std::ios::end);
+    double file_size = static_cast<double>(in.tellg());
+    in.seekg(0, std::ios::beg);
+
+    // Existing templates, indexed by normalized title in every locale
+    json existing = response_datas(client.get("/api/vulnerabilities"));
+    std::unordered_map<std::string, const json*> by_title;
+    if (existing.is_array()) {
+        for (const auto& vulnerability : existing) {
+            for (const auto& detail : vulnerability.value("details", json::array())) {
+                by_title.emplace(normalize_title(detail.value("title", "")), &vulnerability);
+            }
+        }
+    }
+    std::set<std::string> seen;
+
+    size_t rows = 0, created = 0, updated = 0, skipped = 0, invalid = 0, failed = 0;
+    size_t peak_concurrency = 0;
+    json errors = json::array();
+    auto record_error = [&](size_t line, const std::string& message) {
+        if (errors.size() < MAX_REPORTED_ERRORS) errors.push_back({{"line", line}, {"error", message}});
+    };
+
+    std::vector<ImportRow> chunk;
+    auto flush = [&](size_t bytes_read) {
+        std::vector<std::vector<const ImportRow*>> batches;
+        std::vector<const ImportRow*> updates;
+        for (const auto& row : chunk) {
+            if (row.existing) {
+                updates.push_back(&row);
+            } else {
+                if (batches.empty() || batches.back().size() >= batch_size) batches.emplace_back();
+                batches.back().push_back(&row);
+            }
+        }
+
+        if (!dry_run) {
+            PipelineStats stats;
+            auto results = run_pipelined(batches.size() + updates.size(), max_parallel, [&](size_t i) {
+                if (i < batches.size()) {
+                    json body = json::array();
+                    for (const ImportRow* row : batches[i]) body.push_back(row->vulnerability);
+                    return client.post("/api/vulnerabilities", body);
+                }
+                const ImportRow* row = updates[i - batches.size()];
+                return client.put("/api/vulnerabilities/" + row->existing->value("_id", ""),
+                                  merge_vulnerability(*row->existing, row->vulnerability));
+            }, stats);
+            peak_concurrency = std::max(peak_concurrency, stats.peak_concurrency);
+
+            for (size_t i = 0; i < results.size(); ++i) {
+                bool is_batch = i < batches.size();
+                size_t count = is_batch ? batches[i].size() : 1;
+                if (results[i].ok) {
+                    (is_batch ? created : updated) += count;
+                } else {
+                    failed += count;
+                    record_error(is_batch ? batches[i].front()->line : updates[i - batches.size()]->line,
+                                 results[i].error);
+                }
+            }
+        } else {
+            for (const auto& batch : batches) created += batch.size();
+            updated += updates.size();
+        }
+
+        chunk.clear();
+        if (file_size > 0) {
+            progress(static_cast<double>(bytes_read), file_size,
+                     "Imported " + std::to_string(rows) + " rows");
+        }
+    };
+
+    auto add_row = [&](size_t line, const json& row) {
+        ++rows;
+        json vulnerability;
+        try {
+            vulnerability = to_vulnerability(row, locale);
+        } catch (const std::exception& e) {
+            ++invalid;
+            record_error(line, e.what());
+            return;
+        }
+
+        std::string title = normalize_title(vulnerability["details"][0]["title"].get<std::string>());
+        if (!seen.insert(title).second) {
+            ++invalid;
+            record_error(line, "duplicate title in file");
+            return;
+        }
+        auto it = by_title.find(title);
+        if (it != by_title.end() && !update_existing) {
+            ++skipped;
+            return;
+        }
+        chunk.push_back({line, std::move(vulnerability), it == by_title.end() ? nullptr : it->second});
+    };
+
+    if (format == "csv") {
+        CsvReader csv(in);
+        std::vector<std::string> header;
+        std::vector<std::string> fields;
+        if (!csv.read_row(header)) throw std::runtime_error("CSV file is empty");
+        if (!header.empty() && header[0].rfind("\xEF\xBB\xBF", 0) == 0) header[0].erase(0, 3);
+
+        size_t line = 1;
+        while (csv.read_row(fields)) {
+            ++line;
+            if (fields.size() == 1 && fields[0].empty()) continue;
+            json row = json::object();
+            for (size_t i = 0; i < fields.size() && i < header.size(); ++i) {
+                if (!fields[i].empty()) row[header[i]] = fields[i];
+            }
+            add_row(line, row);
+            if (chunk.size() >= IMPORT_CHUNK_ROWS) flush(csv.bytes_read());
+        }
+        flush(csv.bytes_read());
+    } else {
+        std::string text;
+        size_t line = 0;
+        size_t bytes = 0;
+        while (std::getline(in, text)) {
+            ++line;
+            bytes += text.size() + 1;
+            if (text.find_first_not_of(" \t\r") == std::string::npos) continue;
+            json row = json::parse(text, nullptr, false);
+            if (row.is_discarded()) {
+                ++rows;
+                ++invalid;
+                record_error(line, "invalid JSON");
+                continue;
+            }
+            add_row(line, row);
+            if (chunk.size() >= IMPORT_CHUNK_ROWS) flush(bytes);
+        }
+        flush(bytes);
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = elapsed > 0.0 ? rows / elapsed : 0.0;
+    return {
+        {"file_path", path},
+        {"format", format},
+        {"dry_run", dry_run},
+        {"summary", {
+            {"rows", rows},
+            {"created", created},
+            {"updated", updated},
+            {"skipped", skipped},
+            {"invalid", invalid},
+            {"failed", failed},
+            {"elapsed_ms", static_cast<long long>(elapsed * 1000)},
+            {"rows_per_second", std::round(rate * 100.0) / 100.0},
+            {"peak_concurrency", peak_concurrency}
+        }},
+        {"errors", errors}
+    };
+}
+
+// ============================================================================
+// Vulnerability replication
+// ============================================================================
+
+namespace {
+
+/**
+ * Client for the instance vulnerabilities are replicated to: a named target
+ * profile or a config file, so its credentials never pass through tool
+ * arguments. Settings the source and target share (timeouts, concurrency)
+ * start from the source configuration unless a target config file is given.
+ */
+Config target_config(const Config& source, const json& args) {
+    Config config;
+    if (args.contains("target")) {
+        std::string name = args["target"].get<std::string>();
+        config = Config::target(name, source);
+        if (config.url.empty()) {
+            throw std::runtime_error("Unknown target '" + name + "': add it under \"targets\" in the config file "
+                                     "or set its PWNDOC_TARGET_<NAME>_URL");
+        }
+    } else if (args.contains("target_config")) {
+        config = Config::from_file(args["target_config"].get<std::string>());
+    } else {
+        throw std::runtime_error("sync_vulnerabilities requires 'target' (a target profile) or 'target_config'");
+    }
+    while (!config.url.empty() && config.url.back() == '/') config.url.pop_back();
+
+    auto errors = config.validate();
+    if (!errors.empty()) {
+        throw std::runtime_error("Invalid target configuration: " + errors.front());
+    }
+    if (config.url == source.url) {
+        throw std::runtime_error("Target instance is the same as the source");
+    }
+    return config;
+}
+
+/**
+ * Template without the fields the server assigns
+ */
+json template_content(json vulnerability) {
+    for (const char* key : {"_id", "__v", "createdAt", "updatedAt"}) {
+        vulnerability.erase(key);
+    }
+    if (vulnerability.contains("details") && vulnerability["details"].is_array()) {
+        for (auto& detail : vulnerability["details"]) {
+            if (detail.is_object()) detail.erase("_id");
+        }
+    } else {
+        vulnerability["details"] = json::array();
+    }
+    return vulnerability;
+}
+
+// Restrict an object to the keys of `shape`, missing keys becoming null
+json project(const json& object, const json& shape) {
+    json out = json::object();
+    for (const auto& [key, value] : shape.items()) {
+        auto it = object.find(key);
+        out[key] = it == object.end() ? json() : *it;
+    }
+    return out;
+}
+
+/**
+ * SHA-256 per locale of a template's shared fields and that locale's
+ * detail. Both sides are projected onto the source template's fields, so
+ * defaults added by the target server do not count as changes.
+ */
+std::map<std::string, std::string> locale_hashes(const json& content, const json& shape) {
+    json common = project(content, shape);
+    common.erase("details");
+    std::string prefix = common.dump() + "\n";
+
+    std::map<std::string, const json*> shape_details;
+    for (const auto& detail : shape["details"]) {
+        shape_details.emplace(detail.value("locale", ""), &detail);
+    }
+
+    std::map<std::string, std::string> hashes;
+    for (const auto& detail : content["details"]) {
+        std::string locale = detail.value("locale", "");
+        auto it = shape_details.find(locale);
+        std::string text = prefix + (it == shape_details.end() ? detail : project(detail, *it->second)).dump();
+        hashes[locale] = Sha256::hash(text.data(), text.size());
+    }
+    return hashes;
+}
+
+/**
+ * Write planned by a sync: create or update one template, or delete a batch
+ */
+struct SyncChange {
+    std::string action;
+    std::vector<std::string> titles;
+    std::vector<std::string> locales;
+    json body;
+    std::string target_id;
+    std::vector<std::string> delete_ids;
+};
+
+std::string first_title(const json& vulnerability) {
+    for (const auto& detail : vulnerability.value("details", json::array())) {
+        std::string title = detail.value("title", "");
+        if (!title.empty()) return title;
+    }
+    return "";
+}
+
+} // namespace
+
+json sync_vulnerabilities(PwnDocClient& client, const json& args) {
+    Config config = target_config(client.config(), args);
+    PwnDocClient target(config);
+    bool delete_missing = args.value("delete_missing", false);
+    bool dry_run = args.value("dry_run", false);
+    size_t batch_size = static_cast<size_t>(std::max(1, args.value("batch_size", 50)));
+    int limit = client.config().max_concurrency;
+    size_t max_parallel = static_cast<size_t>(std::clamp(args.value("max_parallel", limit), 1, limit));
+    auto start = std::chrono::steady_clock::now();
+
+    // Both sides are fetched concurrently
+    json lists[2];
+    PwnDocClient* clients[2] = {&client, &target};
+    parallel_for(2, 2, [&](size_t i) {
+        lists[i] = response_datas(clients[i]->get("/api/vulnerabilities"));
+        if (!lists[i].is_array()) lists[i] = json::array();
+    });
+    const json& source_list = lists[0];
+    const json& target_list = lists[1];
+
+    // Target templates indexed by locale and normalized title
+    std::unordered_map<std::string, std::vector<size_t>> target_by_title;
+    for (size_t i = 0; i < target_list.size(); ++i) {
+        for (const auto& detail : target_list[i].value("details", json::array())) {
+            target_by_title[detail.value("locale", "") + '\x1f' + normalize_title(detail.value("title", ""))].push_back(i);
+        }
+    }
+
+    std::vector<SyncChange> changes;
+    std::vector<bool> target_matched(target_list.size(), false);
+    size_t unchanged = 0;
+    size_t create_batch = std::string::npos;
+    for (const auto& vulnerability : source_list) {
+        json content = template_content(vulnerability);
+        std::string title = first_title(content);
+
+        // Each target template is matched at most once, so repeated titles pair up
+        const json* match = nullptr;
+        for (const auto& detail : content["details"]) {
+            auto it = target_by_title.find(detail.value("locale", "") + '\x1f' + normalize_title(detail.value("title", "")));
+            if (it == target_by_title.end()) continue;
+            for (size_t index : it->second) {
+                if (target_matched[index]) continue;
+                target_matched[index] = true;
+                match = &target_list[index];
+                break;
+            }
+            if (match) break;
+        }
+
+        if (!match) {
+            // New templates are grouped into batched creates
+            if (create_batch == std::string::npos || changes[create_batch].body.size() >= batch_size) {
+                create_batch = changes.size();
+                changes.push_back({"create", {}, {}, json::array(), "", {}});
+            }
+            changes[create_batch].titles.push_back(title);
+            changes[create_batch].body.push_back(std::move(content));
+            continue;
+        }
+
+        auto wanted = locale_hashes(content, content);
+        auto current = locale_hashes(template_content(*match), content);
+        std::vector<std::string> changed;
+        for (const auto& [locale, hash] : wanted) {
+            auto it = current.find(locale);
+            if (it == current.end() || it->second != hash) changed.push_back(locale);
+        }
+        for (const auto& [locale, hash] : current) {
+            if (!wanted.count(locale)) changed.push_back(locale);
+        }
+        if (changed.empty()) {
+            ++unchanged;
+            continue;
+        }
+        changes.push_back({"update", {title}, changed, std::move(content), match->value("_id", ""), {}});
+    }
+
+    // Target templates without a source counterpart are only deleted on
+    // request; otherwise they are listed so the deletion can be previewed
+    size_t extra = 0;
+    json kept = json::array();
+    for (size_t i = 0; i < target_list.size(); ++i) {
+        if (target_matched[i]) continue;
+        ++extra;
+        if (!delete_missing) {
+            if (kept.size() < MAX_REPORTED_ERRORS) kept.push_back(first_title(target_list[i]));
+            continue;
+        }
+        if (changes.empty() || changes.back().action != "delete" || changes.back().delete_ids.size() >= batch_size) {
+            changes.push_back({"delete", {}, {}, json(), "", {}});
+        }
+        changes.back().delete_ids.push_back(target_list[i].value("_id", ""));
+        changes.back().titles.push_back(first_title(target_list[i]));
+    }
+
+    PipelineStats stats;
+    std::vector<PipelineResult> results;
+    if (!dry_run) {
+        results = run_pipelined(changes.size(), max_parallel, [&](size_t i) {
+            const SyncChange& change = changes[i];
+            if (change.action == "create") return target.post("/api/vulnerabilities", change.body);
+            if (change.action == "update") return target.put("/api/vulnerabilities/" + change.target_id, change.body);
+            return target.del("/api/vulnerabilities", {{"vulnIds", change.delete_ids}});
+        }, stats, [&, progress = ProgressScope::current()](size_t done) {
+            progress(static_cast<double>(done), static_cast<double>(changes.size()),
+                     "Applied " + std::to_string(done) + " of " + std::to_string(changes.size()) + " changes");
+        });
+    }
+
+    size_t created = 0, updated = 0, deleted = 0, failed = 0;
+    json items = json::array();
+    for (size_t i = 0; i < changes.size(); ++i) {
+        const SyncChange& change = changes[i];
+        bool ok = dry_run || results[i].ok;
+        size_t count = change.titles.size();
+        if (!ok) {
+            failed += count;
+        } else if (change.action == "create") {
+            created += count;
+        } else if (change.action == "update") {
+            updated += count;
+        } else {
+            deleted += count;
+        }
+
+        // Batches are reported per template; successes only up to the cap
+        for (const auto& title : change.titles) {
+            if (ok && items.size() >= MAX_REPORTED_ERRORS) break;
+            json item = {{"action", change.action}, {"title", title}, {"status", ok ? (dry_run ? "planned" : "done") : "error"}};
+            if (!change.locales.empty()) item["locales"] = change.locales;
+            if (!ok) item["error"] = results[i].error;
+            items.push_back(std::move(item));
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    json result = {
+        {"source", client.config().url},
+        {"target", config.url},
+        {"dry_run", dry_run},
+        {"summary", {
+            {"source_templates", source_list.size()},
+            {"target_templates", target_list.size()},
+            {"unchanged", unchanged},
+            {"created", created},
+            {"updated", updated},
+            {"deleted", deleted},
+            {"extra", extra},
+            {"failed", failed},
+            {"requests", changes.size()},
+            {"elapsed_ms", static_cast<long long>(elapsed * 1000)},
+            {"peak_concurrency", stats.peak_concurrency}
+        }},
+        {"changes", items}
+    };
+    if (!delete_missing && extra > 0) {
+        result["extra_titles"] = kept;
+    }
+    return result;
+}
@@ -0,0 +1,141 @@
+#include "job_queue.hpp"
+#include <algorithm>
+
+using json = nlohmann::json;
+
+namespace {
+
+const char* state_name(int state) {
+    static const char* names[] = {"queued", "running", "completed", "failed"};
+    return names[state];
+}
+
+long long elapsed_ms(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+} // namespace
+
+JobQueue::JobQueue(size_t workers, size_t max_finished)
+    : workers_(std::max<size_t>(1, workers)), max_finished_(max_finished) {}
+
+JobQueue::~JobQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        pending_.clear();
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+std::string JobQueue::submit(const std::string& key, const json& info, Work work) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!key.empty()) {
+        for (const auto& [id, job] : jobs_) {
+            if (job->key == key && (job->state == State::Queued || job->state == State::Running)) {
+                return id;
+            }
+        }
+    }
+
+    auto job = std::make_shared<Job>();
+    job->id = "job-" + std::to_string(next_id_++);
+    job->key = key;
+    job->info = info;
+    job->work = std::move(work);
+    job->queued = std::chrono::steady_clock::now();
+    jobs_[job->id] = job;
+    pending_.push_back(job);
+
+    // Grow the pool up to its bound as work arrives
+    if (threads_.size() < workers_) {
+        threads_.emplace_back(&JobQueue::run_worker, this);
+    }
+    cv_.notify_one();
+    return job->id;
+}
+
+std::optional<json> JobQueue::status(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) return std::nullopt;
+    return describe(*it->second);
+}
+
+json JobQueue::list() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (const auto& [id, job] : jobs_) jobs.push_back(job);
+    std::sort(jobs.begin(), jobs.end(), [](const auto& a, const auto& b) { return a->queued < b->queued; });
+
+    json result = json::array();
+    for (const auto& job : jobs) result.push_back(describe(*job));
+    return result;
+}
+
+void JobQueue::run_worker() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            if (stopping_) return;
+            job = pending_.front();
+            pending_.pop_front();
+            job->state = State::Running;
+            job->started = std::chrono::steady_clock::now();
+        }
+
+        json result;
+        std::string error;
+        bool ok = true;
+        try {
+            result = job->work();
+        } catch (const std::exception& e) {
+            ok = false;
+            error = e.what();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->state = ok ? State::Completed : State::Failed;
+        job->result = std::move(result);
+        job->error = std::move(error);
+        job->finished = std::chrono::steady_clock::now();
+        job->work = nullptr;
+
+        finished_order_.push_back(job->id);
+        while (finished_order_.size() > max_finished_) {
+            jobs_.erase(finished_order_.front());
+            finished_order_.pop_front();
+        }
+    }
+}
+
+json JobQueue::describe(const Job& job) const {
+    auto now = std::chrono::steady_clock::now();
+    json status = job.info.is_object() ? job.info : json::object();
+    status["job_id"] = job.id;
+    status["status"] = state_name(static_cast<int>(job.state));
+
+    switch (job.state) {
+        case State::Queued:
+            status["queued_ms"] = elapsed_ms(job.queued, now);
+            break;
+        case State::Running:
+            status["queued_ms"] = elapsed_ms(job.queued, job.started);
+            status["running_ms"] = elapsed_ms(job.started, now);
+            break;
+        case State::Completed:
+        case State::Failed:
+            status["queued_ms"] = elapsed_ms(job.queued, job.started);
+            status["running_ms"] = elapsed_ms(job.started, job.finished);
+            if (job.state == State::Completed) status["result"] = job.result;
+            else status["error"] = job.error;
+            break;
+    }
+    return status;
+}
@@ -0,0 +1,44 @@
+#include "list_pages.hpp"
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+using json = nlohmann::json;
+
+ListPages::ListPages(std::chrono::seconds ttl, size_t max_lists)
+    : ttl_(ttl), max_lists_(max_lists) {}
+
+std::string ListPages::store(const std::string& tool, json response) {
+    static thread_local std::mt19937_64 random{std::random_device{}()};
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << random();
+    std::string id = oss.str();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.push_front(id);
+    entries_[id] = {tool, std::make_shared<const json>(std::move(response)),
+                    std::chrono::steady_clock::now(), lru_.begin()};
+
+    while (entries_.size() > max_lists_) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+    }
+    return id;
+}
+
+std::shared_ptr<const json> ListPages::find(const std::string& id, const std::string& tool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end() || it->second.tool != tool) return nullptr;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - it->second.used > ttl_) {
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+        return nullptr;
+    }
+
+    it->second.used = now;
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return it->second.response;
+}
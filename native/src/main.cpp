@@ -23,6 +23,9 @@
 #include "config.hpp"
 #include "client.hpp"
 #include "tools.hpp"
+#include "importers.hpp"
+#include "exporters.hpp"
+#include "snapshot.hpp"
 
 // Version info from CMake
 #ifndef PWNDOC_VERSION
@@ -65,6 +68,18 @@ void print_help() {
     std::cout << "  tools            List all available MCP tools" << std::endl;
     std::cout << "  version          Show version information" << std::endl;
     std::cout << "  config init      Interactive configuration wizard" << std::endl;
+    std::cout << "  import-nmap AUDIT_ID FILE [--scope NAME] [--include-closed] [--include-down] [--replace-all]" << std::endl;
+    std::cout << "                   Import an Nmap XML scan into the audit network" << std::endl;
+    std::cout << "  import-vulns FILE [--format csv|ndjson] [--locale LOCALE] [--skip-existing] [--dry-run]" << std::endl;
+    std::cout << "                   Import vulnerability templates from CSV or NDJSON" << std::endl;
+    std::cout << "  sync-vulns (--target NAME | --target-config FILE) [--delete-missing] [--dry-run]" << std::endl;
+    std::cout << "                   Replicate vulnerability templates to another instance" << std::endl;
+    std::cout << "  export-findings [PATH] [--enrich] [--audit ID]... [--parallel N]" << std::endl;
+    std::cout << "                   Export all findings to an NDJSON file" << std::endl;
+    std::cout << "  snapshot [PATH] [--no-images] [--parallel N]" << std::endl;
+    std::cout << "                   Back up the whole instance to a gzip NDJSON archive" << std::endl;
+    std::cout << "  restore FILE [--no-reuse] [--parallel N]" << std::endl;
+    std::cout << "                   Restore a snapshot archive into this instance" << std::endl;
     std::cout << "  claude-install   Install MCP config for Claude Desktop" << std::endl;
     std::cout << "  claude-status    Check Claude Desktop installation status" << std::endl;
     std::cout << "  claude-uninstall Remove MCP config from Claude Desktop" << std::endl;
@@ -190,11 +205,24 @@ int cmd_tools() {
         categories["Roles"] = {};
         categories["Images"] = {};
         categories["Statistics"] = {};
+        categories["Batch"] = {};
+        categories["Results"] = {};
+        categories["Import"] = {};
+        categories["Backup"] = {};
 
         // Categorize tools
         for (const auto& tool : tools) {
             std::string name = tool["name"].get<std::string>();
-            if (name.find("audit") != std::string::npos && name.find("type") == std::string::npos) {
+            if (name == "batch") {
+                categories["Batch"].push_back(tool);
+            } else if (name == "read_result") {
+                categories["Results"].push_back(tool);
+            } else if (name.rfind("import_", 0) == 0) {
+                categories["Import"].push_back(tool);
+            } else if (name == "snapshot" || name == "restore") {
+                categories["Backup"].push_back(tool);
+            } else if ((name.find("audit") != std::string::npos && name.find("type") == std::string::npos) ||
+                       name.find("report") != std::string::npos) {
                 categories["Audits"].push_back(tool);
             } else if (name.find("finding") != std::string::npos) {
                 categories["Findings"].push_back(tool);
@@ -254,6 +282,313 @@ int cmd_tools() {
     }
 }
 
+// Import Nmap scan command
+int cmd_import_nmap(const std::vector<std::string>& args) {
+    try {
+        nlohmann::json arguments = {
+            {"audit_id", args[1]},
+            {"file_path", args[2]}
+        };
+        for (size_t i = 3; i < args.size(); ++i) {
+            if (args[i] == "--scope" && i + 1 < args.size()) {
+                arguments["scope_name"] = args[++i];
+            } else if (args[i] == "--include-closed") {
+                arguments["include_closed"] = true;
+            } else if (args[i] == "--include-down") {
+                arguments["include_down"] = true;
+            } else if (args[i] == "--replace-all") {
+                arguments["replace_all"] = true;
+            } else {
+                std::cerr << "Error: Unknown option '" << args[i] << "'" << std::endl;
+                return 1;
+            }
+        }
+
+        Config config = Config::load();
+        auto errors = config.validate();
+        if (!errors.empty()) {
+            std::cerr << "Configuration errors:" << std::endl;
+            for (const auto& error : errors) {
+                std::cerr << "  ✗ " << error << std::endl;
+            }
+            return 1;
+        }
+
+        PwnDocClient client(config);
+        auto result = import_nmap(client, arguments);
+
+        std::cout << "✓ Imported scope '" << result["scope_name"].get<std::string>() << "'" << std::endl;
+        std::cout << "  Hosts: " << result["hosts"] << " (" << result["hosts_skipped"] << " skipped)" << std::endl;
+        std::cout << "  Services: " << result["services"] << " (" << result["ports_skipped"] << " ports skipped)" << std::endl;
+        std::cout << "  Read " << result["bytes_read"] << " bytes in " << result["elapsed_ms"] << " ms" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// Import vulnerability templates command
+int cmd_import_vulns(const std::vector<std::string>& args) {
+    try {
+        nlohmann::json arguments = {{"file_path", args[1]}};
+        for (size_t i = 2; i < args.size(); ++i) {
+            if (args[i] == "--format" && i + 1 < args.size()) {
+                arguments["format"] = args[++i];
+            } else if (args[i] == "--locale" && i + 1 < args.size()) {
+                arguments["locale"] = args[++i];
+            } else if (args[i] == "--skip-existing") {
+                arguments["on_existing"] = "skip";
+            } else if (args[i] == "--dry-run") {
+                arguments["dry_run"] = true;
+            } else {
+                std::cerr << "Error: Unknown option '" << args[i] << "'" << std::endl;
+                return 1;
+            }
+        }
+
+        Config config = Config::load();
+        auto errors = config.validate();
+        if (!errors.empty()) {
+            std::cerr << "Configuration errors:" << std::endl;
+            for (const auto& error : errors) {
+                std::cerr << "  ✗ " << error << std::endl;
+            }
+            return 1;
+        }
+
+        PwnDocClient client(config);
+        auto result = import_vulnerabilities(client, arguments);
+        const auto& summary = result["summary"];
+
+        std::cout << (summary["failed"] == 0 ? "✓" : "✗") << " Imported " << summary["rows"] << " rows"
+                  << (result["dry_run"].get<bool>() ? " (dry run)" : "") << std::endl;
+        std::cout << "  Created: " << summary["created"] << ", updated: " << summary["updated"]
+                  << ", skipped: " << summary["skipped"] << std::endl;
+        std::cout << "  Invalid: " << summary["invalid"] << ", failed: " << summary["failed"] << std::endl;
+        for (const auto& error : result["errors"]) {
+            std::cout << "    line " << error["line"] << ": " << error["error"].get<std::string>() << std::endl;
+        }
+        std::cout << "  " << summary["rows_per_second"] << " rows/s in " << summary["elapsed_ms"] << " ms" << std::endl;
+        return summary["failed"] == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// Vulnerability replication command
+int cmd_sync_vulns(const std::vector<std::string>& args) {
+    try {
+        nlohmann::json arguments = nlohmann::json::object();
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (args[i] == "--target" && i + 1 < args.size()) {
+                arguments["target"] = args[++i];
+            } else if (args[i] == "--target-config" && i + 1 < args.size()) {
+                arguments["target_config"] = args[++i];
+            } else if (args[i] == "--delete-missing") {
+                arguments["delete_missing"] = true;
+            } else if (args[i] == "--dry-run") {
+                arguments["dry_run"] = true;
+            } else {
+                std::cerr << "Error: Unknown option '" << args[i] << "'" << std::endl;
+                return 1;
+            }
+        }
+        if (!arguments.contains("target") && !arguments.contains("target_config")) {
+            std::cerr << "Error: --target or --target-config is required" << std::endl;
+            return 1;
+        }
+
+        Config config = Config::load();
+        auto errors = config.validate();
+        if (!errors.empty()) {
+            std::cerr << "Configuration errors:" << std::endl;
+            for (const auto& error : errors) {
+                std::cerr << "  ✗ " << error << std::endl;
+            }
+            return 1;
+        }
+
+        PwnDocClient client(config);
+        auto result = sync_vulnerabilities(client, arguments);
+        const auto& summary = result["summary"];
+
+        std::cout << (summary["failed"] == 0 ? "✓" : "✗") << " Synced " << summary["source_templates"]
+                  << " templates to " << result["target"].get<std::string>()
+                  << (result["dry_run"].get<bool>() ? " (dry run)" : "") << std::endl;
+        std::cout << "  Created: " << summary["created"] << ", updated: " << summary["updated"]
+                  << ", deleted: " << summary["deleted"] << ", unchanged: " << summary["unchanged"] << std::endl;
+        if (result.contains("extra_titles")) {
+            std::cout << "  Kept " << summary["extra"] << " target templates missing from the source"
+                      << " (--delete-missing deletes them):" << std::endl;
+            for (const auto& title : result["extra_titles"]) {
+                std::cout << "    " << title.get<std::string>() << std::endl;
+            }
+        }
+        for (const auto& change : result["changes"]) {
+            if (change["status"] != "error") continue;
+            std::cout << "    " << change["action"].get<std::string>() << " " << change["title"].get<std::string>()
+                      << ": " << change["error"].get<std::string>() << std::endl;
+        }
+        std::cout << "  Failed: " << summary["failed"] << ", " << summary["requests"] << " requests in "
+                  << summary["elapsed_ms"] << " ms" << std::endl;
+        return summary["failed"] == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// Findings export command
+int cmd_export_findings(const std::vector<std::string>& args) {
+    try {
+        nlohmann::json arguments = nlohmann::json::object();
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (args[i] == "--enrich") {
+                arguments["enrich"] = true;
+            } else if (args[i] == "--audit" && i + 1 < args.size()) {
+                arguments["audit_ids"].push_back(args[++i]);
+            } else if (args[i] == "--parallel" && i + 1 < args.size()) {
+                arguments["max_parallel"] = std::stoi(args[++i]);
+            } else if (args[i].rfind("--", 0) != 0 && !arguments.contains("output_path")) {
+                arguments["output_path"] = args[i];
+            } else {
+                std::cerr << "Error: Unknown option '" << args[i] << "'" << std::endl;
+                return 1;
+            }
+        }
+
+        Config config = Config::load();
+        auto errors = config.validate();
+        if (!errors.empty()) {
+            std::cerr << "Configuration errors:" << std::endl;
+            for (const auto& error : errors) {
+                std::cerr << "  ✗ " << error << std::endl;
+            }
+            return 1;
+        }
+
+        PwnDocClient client(config);
+        auto result = export_findings(client, arguments);
+        size_t error_count = result["error_count"].get<size_t>();
+
+        std::cout << (error_count == 0 ? "✓" : "✗") << " Exported " << result["findings"] << " findings from "
+                  << result["audits"] << " audits to " << result["path"].get<std::string>() << std::endl;
+        for (const auto& error : result["errors"]) {
+            std::cout << "    audit " << error["audit_id"].get<std::string>() << ": "
+                      << error["error"].get<std::string>() << std::endl;
+        }
+        std::cout << "  " << result["bytes"] << " bytes in " << result["elapsed_ms"] << " ms" << std::endl;
+        return error_count == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// Snapshot command
+int cmd_snapshot(const std::vector<std::string>& args) {
+    try {
+        nlohmann::json arguments = nlohmann::json::object();
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (args[i] == "--no-images") {
+                arguments["include_images"] = false;
+            } else if (args[i] == "--parallel" && i + 1 < args.size()) {
+                arguments["max_parallel"] = std::stoi(args[++i]);
+            } else if (args[i].rfind("--", 0) != 0 && !arguments.contains("output_path")) {
+                arguments["output_path"] = args[i];
+            } else {
+                std::cerr << "Error: Unknown option '" << args[i] << "'" << std::endl;
+                return 1;
+            }
+        }
+
+        Config config = Config::load();
+        auto errors = config.validate();
+        if (!errors.empty()) {
+            std::cerr << "Configuration errors:" << std::endl;
+            for (const auto& error : errors) {
+                std::cerr << "  ✗ " << error << std::endl;
+            }
+            return 1;
+        }
+
+        PwnDocClient client(config);
+        auto result = snapshot(client, arguments);
+        size_t error_count = result["error_count"].get<size_t>();
+
+        std::cout << (error_count == 0 ? "✓" : "✗") << " Saved " << result["records"] << " records to "
+                  << result["path"].get<std::string>() << std::endl;
+        for (const auto& [type, count] : result["counts"].items()) {
+            std::cout << "  " << type << ": " << count << std::endl;
+        }
+        for (const auto& error : result["errors"]) {
+            std::cout << "    " << error["type"].get<std::string>() << " " << error.value("id", "")
+                      << ": " << error["error"].get<std::string>() << std::endl;
+        }
+        std::cout << "  " << result["bytes"] << " bytes (" << result["uncompressed_bytes"]
+                  << " uncompressed) in " << result["elapsed_ms"] << " ms" << std::endl;
+        return error_count == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// Restore command
+int cmd_restore(const std::vector<std::string>& args) {
+    try {
+        nlohmann::json arguments = {{"file_path", args[1]}};
+        for (size_t i = 2; i < args.size(); ++i) {
+            if (args[i] == "--no-reuse") {
+                arguments["reuse_existing"] = false;
+            } else if (args[i] == "--parallel" && i + 1 < args.size()) {
+                arguments["max_parallel"] = std::stoi(args[++i]);
+            } else {
+                std::cerr << "Error: Unknown option '" << args[i] << "'" << std::endl;
+                return 1;
+            }
+        }
+
+        Config config = Config::load();
+        auto errors = config.validate();
+        if (!errors.empty()) {
+            std::cerr << "Configuration errors:" << std::endl;
+            for (const auto& error : errors) {
+                std::cerr << "  ✗ " << error << std::endl;
+            }
+            return 1;
+        }
+
+        PwnDocClient client(config);
+        auto result = restore(client, arguments);
+        size_t error_count = result["error_count"].get<size_t>();
+
+        std::cout << (error_count == 0 ? "✓" : "✗") << " Restored snapshot of "
+                  << result["source"].get<std::string>() << " taken " << result["created_at"].get<std::string>() << std::endl;
+        for (const auto& [type, outcomes] : result["counts"].items()) {
+            std::cout << "  " << type << ":";
+            for (const auto& [outcome, count] : outcomes.items()) {
+                std::cout << " " << outcome << " " << count;
+            }
+            std::cout << std::endl;
+        }
+        for (const auto& error : result["errors"]) {
+            std::cout << "    " << error["type"].get<std::string>() << " " << error.value("id", "")
+                      << ": " << error["error"].get<std::string>() << std::endl;
+        }
+        for (const auto& level : result["levels"]) {
+            std::cout << "  " << level["level"].get<std::string>() << ": " << level["elapsed_ms"] << " ms" << std::endl;
+        }
+        std::cout << "  Total: " << result["elapsed_ms"] << " ms" << std::endl;
+        return error_count == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
 // Config init command
 int cmd_config_init() {
     std::cout << "=== PwnDoc MCP Server Configuration ===" << std::endl;
@@ -447,6 +782,36 @@ int main(int argc, char* argv[]) {
             return cmd_config_init();
         }
 
+        // Handle import-nmap command
+        if (argc >= 4 && std::string(argv[1]) == "import-nmap") {
+            return cmd_import_nmap(args);
+        }
+
+        // Handle import-vulns command
+        if (argc >= 3 && std::string(argv[1]) == "import-vulns") {
+            return cmd_import_vulns(args);
+        }
+
+        // Handle sync-vulns command
+        if (argc >= 3 && std::string(argv[1]) == "sync-vulns") {
+            return cmd_sync_vulns(args);
+        }
+
+        // Handle export-findings command
+        if (argc >= 2 && std::string(argv[1]) == "export-findings") {
+            return cmd_export_findings(args);
+        }
+
+        // Handle snapshot command
+        if (argc >= 2 && std::string(argv[1]) == "snapshot") {
+            return cmd_snapshot(args);
+        }
+
+        // Handle restore command
+        if (argc >= 3 && std::string(argv[1]) == "restore") {
+            return cmd_restore(args);
+        }
+
         // Handle claude-install command
         if (argc == 2 && std::string(argv[1]) == "claude-install") {
             return cmd_claude_install();
@@ -0,0 +1,57 @@
+#include "object_cache.hpp"
+
+using json = nlohmann::json;
+
+ObjectCache::ObjectCache(std::chrono::seconds ttl, size_t max_entries)
+    : ttl_(ttl), max_entries_(max_entries) {}
+
+void ObjectCache::store(const std::string& key, const json& object) {
+    if (!enabled()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+    }
+
+    lru_.push_front(key);
+    entries_[key] = {object, std::chrono::steady_clock::now(), lru_.begin()};
+
+    while (entries_.size() > max_entries_) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+std::optional<json> ObjectCache::find(const std::string& key) {
+    if (!enabled()) return std::nullopt;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return std::nullopt;
+
+    if (std::chrono::steady_clock::now() - it->second.stored > ttl_) {
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+        return std::nullopt;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return it->second.object;
+}
+
+void ObjectCache::invalidate(const std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        const std::string& key = it->first;
+        bool related = key.compare(0, endpoint.size(), endpoint) == 0 ||
+                       endpoint.compare(0, key.size(), key) == 0;
+        if (related) {
+            lru_.erase(it->second.lru);
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#include "parallel.hpp"
+#include "client.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+void parallel_for(size_t count, size_t max_workers, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+
+    size_t workers = std::max<size_t>(1, std::min(max_workers, count));
+    if (workers == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr first_error;
+    std::mutex error_mutex;
+
+    // Workers run under the deadline of the calling thread
+    auto deadline = RequestDeadline::current();
+    auto worker = [&]() {
+        RequestDeadline inherited(deadline);
+        while (!failed.load()) {
+            size_t i = next.fetch_add(1);
+            if (i >= count) break;
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!first_error) first_error = std::current_exception();
+                failed.store(true);
+            }
+        }
+    };
+
+    // The calling thread takes part in the work instead of idling in join()
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+}
+
+// ============================================================================
+// AdaptiveLimiter Implementation
+// ============================================================================
+
+AdaptiveLimiter::AdaptiveLimiter(size_t initial_limit, size_t max_limit)
+    : limit_(static_cast<double>(std::max<size_t>(1, std::min(initial_limit, max_limit)))),
+      max_limit_(std::max<size_t>(1, max_limit)),
+      peak_(static_cast<size_t>(limit_)) {}
+
+void AdaptiveLimiter::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return in_flight_ < static_cast<size_t>(limit_); });
+    ++in_flight_;
+}
+
+void AdaptiveLimiter::release(bool overloaded) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --in_flight_;
+        if (overloaded) {
+            limit_ = std::max(1.0, limit_ / 2.0);
+        } else {
+            limit_ = std::min(static_cast<double>(max_limit_), limit_ + 1.0 / limit_);
+        }
+        peak_ = std::max(peak_, static_cast<size_t>(limit_));
+    }
+    cv_.notify_all();
+}
+
+size_t AdaptiveLimiter::limit() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(limit_);
+}
+
+size_t AdaptiveLimiter::peak() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_;
+}
@@ -0,0 +1,17 @@
+#include "progress.hpp"
+
+// Sink set by ProgressScope for the current thread
+static thread_local ProgressSink current_sink;
+
+ProgressScope::ProgressScope(ProgressSink sink) : previous_(current_sink) {
+    current_sink = std::move(sink);
+}
+
+ProgressScope::~ProgressScope() {
+    current_sink = previous_;
+}
+
+ProgressSink ProgressScope::current() {
+    if (current_sink) return current_sink;
+    return [](double, double, const std::string&) {};
+}
@@ -0,0 +1,136 @@
+#include "projection.hpp"
+#include <memory>
+#include <sstream>
+
+using json = nlohmann::json;
+
+// Projection set by ProjectionScope for the current thread
+static thread_local const FieldProjection* current_projection = nullptr;
+
+namespace {
+
+std::vector<std::string> split_path(const std::string& path) {
+    std::vector<std::string> segments;
+    bool pointer = !path.empty() && path[0] == '/';
+    std::istringstream parts(pointer ? path.substr(1) : path);
+    std::string segment;
+    while (std::getline(parts, segment, pointer ? '/' : '.')) {
+        if (pointer) {
+            // RFC 6901 escapes
+            for (size_t pos = 0; (pos = segment.find('~', pos)) != std::string::npos; ++pos) {
+                if (pos + 1 < segment.size() && segment[pos + 1] == '1') segment.replace(pos, 2, "/");
+                else if (pos + 1 < segment.size() && segment[pos + 1] == '0') segment.replace(pos, 2, "~");
+            }
+        }
+        size_t start = segment.find_first_not_of(' ');
+        size_t end = segment.find_last_not_of(' ');
+        if (start != std::string::npos) segments.push_back(segment.substr(start, end - start + 1));
+    }
+    return segments;
+}
+
+} // namespace
+
+FieldProjection::FieldProjection(const json& fields) {
+    if (fields.is_string()) {
+        std::istringstream list(fields.get<std::string>());
+        std::string path;
+        while (std::getline(list, path, ',')) add(split_path(path));
+    } else if (fields.is_array()) {
+        for (const auto& path : fields) {
+            if (path.is_string()) add(split_path(path.get<std::string>()));
+        }
+    }
+}
+
+void FieldProjection::add(const std::vector<std::string>& path) {
+    if (path.empty()) return;
+    Node* node = &root_;
+    for (const auto& segment : path) {
+        if (node->keep) return;
+        node = &node->children[segment];
+    }
+    node->keep = true;
+    node->children.clear();
+}
+
+json::parser_callback_t FieldProjection::callback() const {
+    enum class Mode { Envelope, Filter, Keep, Drop };
+    struct Frame {
+        Mode mode;
+        const Node* node;
+        bool array;
+    };
+    struct State {
+        // One frame per open container, indexed by depth. Containers inside
+        // dropped keys never report their end, so the stack is cut back to
+        // the depth of each event instead.
+        std::vector<Frame> frames;
+        Frame pending{Mode::Drop, nullptr, false};
+    };
+    auto state = std::make_shared<State>();
+    const Node* root = &root_;
+
+    // Frame of a value at `depth`, from its container and preceding key
+    auto value_frame = [state, root](int depth) -> Frame {
+        if (depth == 0) return {Mode::Envelope, root, false};
+        const Frame& parent = state->frames[depth - 1];
+        return parent.array ? parent : state->pending;
+    };
+
+    return [state, root, value_frame](int depth, json::parse_event_t event, json& parsed) {
+        auto& frames = state->frames;
+        switch (event) {
+            case json::parse_event_t::object_start:
+            case json::parse_event_t::array_start: {
+                frames.resize(static_cast<size_t>(depth));
+                Frame frame = value_frame(depth);
+                frame.array = event == json::parse_event_t::array_start;
+                // A bare array response is the data itself
+                if (frame.mode == Mode::Envelope && frame.array) frame.mode = Mode::Filter;
+                frames.push_back(frame);
+                return true;
+            }
+            case json::parse_event_t::key: {
+                frames.resize(static_cast<size_t>(depth));
+                const Frame& object = frames.back();
+                const std::string& key = parsed.get_ref<const std::string&>();
+                if (object.mode == Mode::Envelope) {
+                    state->pending = key == "datas" ? Frame{Mode::Filter, root, false}
+                                                    : Frame{Mode::Keep, nullptr, false};
+                    return true;
+                }
+                if (object.mode != Mode::Filter) {
+                    state->pending = object;
+                    return object.mode == Mode::Keep;
+                }
+                auto child = object.node->children.find(key);
+                if (child == object.node->children.end()) {
+                    state->pending = {Mode::Drop, nullptr, false};
+                    return false;
+                }
+                state->pending = {child->second.keep ? Mode::Keep : Mode::Filter, &child->second, false};
+                return true;
+            }
+            case json::parse_event_t::value:
+                if (depth == 0) return true;
+                frames.resize(static_cast<size_t>(depth));
+                return value_frame(depth).mode != Mode::Drop;
+            default:
+                return true;
+        }
+    };
+}
+
+ProjectionScope::ProjectionScope(const FieldProjection& projection)
+    : previous_(current_projection) {
+    current_projection = &projection;
+}
+
+ProjectionScope::~ProjectionScope() {
+    current_projection = previous_;
+}
+
+const FieldProjection* ProjectionScope::current() {
+    return current_projection;
+}
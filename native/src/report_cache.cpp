@@ -0,0 +1,91 @@
+#include "report_cache.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+ReportCache::ReportCache(std::string directory, uint64_t max_bytes)
+    : directory_(std::move(directory)), max_bytes_(max_bytes) {}
+
+std::optional<std::string> ReportCache::find(const std::string& key) {
+    if (!enabled()) return std::nullopt;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code ec;
+    fs::path entry = fs::path(directory_) / key;
+    for (const auto& file : fs::directory_iterator(entry, ec)) {
+        if (!file.is_regular_file(ec)) continue;
+        // Mark as recently used
+        fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+        return file.path().string();
+    }
+    return std::nullopt;
+}
+
+void ReportCache::store(const std::string& key, const std::string& path) {
+    if (!enabled()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code ec;
+    fs::path entry = fs::path(directory_) / key;
+    fs::path staging = fs::path(directory_) / (key + ".tmp");
+
+    // Copy into a staging directory and rename it so readers never see a partial file
+    fs::remove_all(staging, ec);
+    fs::create_directories(staging, ec);
+    if (ec) return;
+    fs::copy_file(path, staging / fs::path(path).filename(), fs::copy_options::overwrite_existing, ec);
+    if (ec) {
+        fs::remove_all(staging, ec);
+        return;
+    }
+    fs::remove_all(entry, ec);
+    fs::rename(staging, entry, ec);
+    if (ec) {
+        fs::remove_all(staging, ec);
+        return;
+    }
+
+    evict();
+}
+
+void ReportCache::clear() {
+    if (!enabled()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code ec;
+    for (const auto& dir : fs::directory_iterator(directory_, ec)) {
+        std::error_code remove_ec;
+        if (dir.is_directory(remove_ec)) fs::remove_all(dir.path(), remove_ec);
+    }
+}
+
+void ReportCache::evict() {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type used;
+        uint64_t bytes = 0;
+    };
+
+    std::error_code ec;
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    for (const auto& dir : fs::directory_iterator(directory_, ec)) {
+        if (!dir.is_directory(ec)) continue;
+        Entry entry{dir.path(), fs::last_write_time(dir.path(), ec), 0};
+        for (const auto& file : fs::directory_iterator(dir.path(), ec)) {
+            if (file.is_regular_file(ec)) entry.bytes += file.file_size(ec);
+        }
+        total += entry.bytes;
+        entries.push_back(std::move(entry));
+    }
+    if (total <= max_bytes_) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const auto& entry : entries) {
+        if (total <= max_bytes_) break;
+        fs::remove_all(entry.path, ec);
+        if (!ec) total -= entry.bytes;
+    }
+}
@@ -0,0 +1,138 @@
+#include "result_store.hpp"
+#include "client.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+ResultStore::ResultStore(std::string directory, uint64_t threshold_bytes, size_t max_results)
+    : directory_(std::move(directory)), threshold_bytes_(threshold_bytes), max_results_(max_results) {}
+
+ResultStore::~ResultStore() {
+    std::error_code ec;
+    for (const auto& path : stored_) {
+        fs::remove(path, ec);
+    }
+}
+
+std::string ResultStore::path_for(const std::string& uri) const {
+    if (uri.rfind(URI_PREFIX, 0) != 0) {
+        throw NotFoundError("Unknown resource: " + uri);
+    }
+    std::string id = uri.substr(std::string(URI_PREFIX).size());
+    if (id.empty() || id.find_first_not_of("0123456789abcdefghijklmnopqrstuvwxyz-_") != std::string::npos) {
+        throw NotFoundError("Unknown resource: " + uri);
+    }
+    return (fs::path(directory_) / (id + ".json")).string();
+}
+
+json ResultStore::store(const std::string& name, const std::string& text) {
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string id = std::to_string(now) + "-" + std::to_string(++counter_);
+    std::string uri = URI_PREFIX + id;
+    std::string path = path_for(uri);
+
+    // Results hold client data: keep them readable by the user only
+    std::lock_guard<std::mutex> lock(mutex_);
+    fs::create_directories(directory_);
+    fs::permissions(directory_, fs::perms::owner_all, fs::perm_options::replace);
+    {
+        std::ofstream out(path + ".tmp", std::ios::binary);
+        fs::permissions(path + ".tmp", fs::perms::owner_read | fs::perms::owner_write,
+                        fs::perm_options::replace);
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!out) {
+            throw PwnDocError("Cannot write " + path + ".tmp");
+        }
+    }
+    fs::rename(path + ".tmp", path);
+    stored_.push_back(path);
+    evict();
+
+    return {{"uri", uri}, {"name", name}, {"path", fs::absolute(path).string()}, {"size", text.size()}};
+}
+
+json ResultStore::read(const std::string& uri, uint64_t offset, uint64_t length) const {
+    std::string path = path_for(uri);
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw NotFoundError("Resource has expired or does not exist: " + uri);
+    }
+    in.seekg(0, std::ios::end);
+    uint64_t total = static_cast<uint64_t>(in.tellg());
+    offset = std::min(offset, total);
+    length = std::min(length, total - offset);
+
+    std::string text(length, '\0');
+    in.seekg(static_cast<std::streamoff>(offset));
+    in.read(&text[0], static_cast<std::streamsize>(length));
+
+    // Never split a multi-byte character; the next range starts at it
+    if (offset + length < total) {
+        size_t end = text.size();
+        size_t back = 0;
+        while (end > 0 && back < 4 && (static_cast<unsigned char>(text[end - 1]) & 0xC0) == 0x80) {
+            --end;
+            ++back;
+        }
+        if (end > 0 && (static_cast<unsigned char>(text[end - 1]) & 0x80)) {
+            unsigned char lead = static_cast<unsigned char>(text[end - 1]);
+            size_t expected = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+            if (expected != back + 1) text.resize(end - 1);
+        }
+    }
+
+    uint64_t next = offset + text.size();
+    return {
+        {"uri", uri},
+        {"text", text},
+        {"offset", offset},
+        {"length", text.size()},
+        {"total_bytes", total},
+        {"next_offset", next < total ? json(next) : json()}
+    };
+}
+
+json ResultStore::list() const {
+    json resources = json::array();
+    if (directory_.empty()) return resources;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<fs::directory_entry> files;
+    std::error_code ec;
+    for (const auto& file : fs::directory_iterator(directory_, ec)) {
+        if (file.is_regular_file(ec) && file.path().extension() == ".json") files.push_back(file);
+    }
+    std::sort(files.begin(), files.end(), [](const fs::directory_entry& a, const fs::directory_entry& b) {
+        return a.path().filename().string() > b.path().filename().string();
+    });
+    for (const auto& file : files) {
+        resources.push_back({
+            {"uri", URI_PREFIX + file.path().stem().string()},
+            {"name", "Tool result " + file.path().stem().string()},
+            {"mimeType", "application/json"},
+            {"size", file.file_size(ec)}
+        });
+    }
+    return resources;
+}
+
+void ResultStore::evict() {
+    std::error_code ec;
+    std::vector<fs::path> files;
+    for (const auto& file : fs::directory_iterator(directory_, ec)) {
+        if (file.is_regular_file(ec) && file.path().extension() == ".json") files.push_back(file.path());
+    }
+    if (files.size() <= max_results_) return;
+
+    // Ids start with a millisecond timestamp, so names order by age
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i + max_results_ < files.size(); ++i) {
+        fs::remove(files[i], ec);
+    }
+}
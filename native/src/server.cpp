@@ -1,15 +1,26 @@
 #include "server.hpp"
 #include "tools.hpp"
+#include "progress.hpp"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <optional>
+#include <thread>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+// resources/read range used when the client does not ask for one, and the largest allowed
+static constexpr uint64_t DEFAULT_READ_BYTES = 64 * 1024;
+static constexpr uint64_t MAX_READ_BYTES = 4 * 1024 * 1024;
+
 Server::Server(const Config& config) : config_(config) {
     client_ = std::make_unique<PwnDocClient>(config);
 }
 
-Server::~Server() = default;
+Server::~Server() {
+    stop_workers();
+}
 
 std::string Server::read_line() {
     std::string line;
@@ -18,14 +29,26 @@ std::string Server::read_line() {
 }
 
 void Server::write_line(const std::string& line) {
+    std::lock_guard<std::mutex> lock(output_mutex_);
     std::cout << line << std::endl;
     std::cout.flush();
 }
 
+// Check whether a raw JSON-RPC line is a tools/call request
+static bool is_tool_call(const std::string& line) {
+    json req = json::parse(line, nullptr, false);
+    return req.is_object() && req.value("method", "") == "tools/call";
+}
+
 void Server::run() {
     while (std::cin) {
         std::string line = read_line();
         if (line.empty()) continue;
+
+        if (is_tool_call(line)) {
+            dispatch_async(line);
+            continue;
+        }
         
         try {
             std::string response = handle_request(line);
@@ -41,6 +64,64 @@ void Server::run() {
             write_line(error_response.dump());
         }
     }
+
+    // Let queued and in-flight tool calls finish before shutting down
+    stop_workers();
+}
+
+void Server::dispatch_async(const std::string& request) {
+    {
+        std::unique_lock<std::mutex> lock(workers_mutex_);
+        size_t limit = static_cast<size_t>(std::max(1, config_.max_concurrency));
+        workers_cv_.wait(lock, [&] { return calls_.size() < limit; });
+        calls_.push_back(request);
+
+        // Grow the pool up to its bound when every worker is busy
+        if (idle_workers_ == 0 && workers_.size() < limit) {
+            workers_.emplace_back(&Server::run_worker, this);
+        }
+    }
+    workers_cv_.notify_all();
+}
+
+void Server::run_worker() {
+    std::unique_lock<std::mutex> lock(workers_mutex_);
+    while (true) {
+        ++idle_workers_;
+        workers_cv_.wait(lock, [this] { return stopping_ || !calls_.empty(); });
+        --idle_workers_;
+        if (calls_.empty()) return;
+
+        std::string request = std::move(calls_.front());
+        calls_.pop_front();
+        lock.unlock();
+        workers_cv_.notify_all();
+
+        try {
+            write_line(handle_request(request));
+        } catch (const std::exception& e) {
+            json error_response = {
+                {"jsonrpc", "2.0"},
+                {"error", {
+                    {"code", -32603},
+                    {"message", e.what()}
+                }}
+            };
+            write_line(error_response.dump());
+        }
+        lock.lock();
+    }
+}
+
+void Server::stop_workers() {
+    {
+        std::lock_guard<std::mutex> lock(workers_mutex_);
+        stopping_ = true;
+    }
+    workers_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
 }
 
 std::string Server::handle_request(const std::string& request) {
@@ -53,10 +134,14 @@ std::string Server::handle_request(const std::string& request) {
     json result;
     
     if (method == "initialize") {
+        // Resource links in tool results need 2025-06-18; older clients get a path instead
+        std::string requested = params.value("protocolVersion", "");
+        resource_links_ = requested >= "2025-06-18";
         result = {
-            {"protocolVersion", "2024-11-05"},
+            {"protocolVersion", resource_links_ ? "2025-06-18" : "2024-11-05"},
             {"capabilities", {
-                {"tools", json::object()}
+                {"tools", json::object()},
+                {"resources", json::object()}
             }},
             {"serverInfo", {
                 {"name", "pwndoc-mcp-server"},
@@ -68,7 +153,39 @@ std::string Server::handle_request(const std::string& request) {
     } else if (method == "tools/call") {
         std::string name = params.value("name", "");
         json arguments = params.value("arguments", json::object());
+
+        // Forward progress of long-running tools if the client asked for it
+        std::optional<ProgressScope> progress;
+        if (params.contains("_meta") && params["_meta"].contains("progressToken")) {
+            json token = params["_meta"]["progressToken"];
+            progress.emplace([this, token](double done, double total, const std::string& message) {
+                json notification_params = {{"progressToken", token}, {"progress", done}};
+                if (total > 0) notification_params["total"] = total;
+                if (!message.empty()) notification_params["message"] = message;
+                write_line(json({
+                    {"jsonrpc", "2.0"},
+                    {"method", "notifications/progress"},
+                    {"params", notification_params}
+                }).dump());
+            });
+        }
         result = handle_call_tool(name, arguments);
+    } else if (method == "resources/list") {
+        result = {{"resources", client_->result_store().list()}};
+    } else if (method == "resources/read") {
+        try {
+            result = handle_read_resource(params);
+        } catch (const NotFoundError& e) {
+            return json({
+                {"jsonrpc", "2.0"},
+                {"id", id},
+                {"error", {
+                    {"code", -32002},
+                    {"message", e.what()},
+                    {"data", {{"uri", params.value("uri", "")}}}
+                }}
+            }).dump();
+        }
     } else if (method == "notifications/initialized") {
         // No response needed for notifications
         return "";
@@ -98,9 +215,20 @@ std::string Server::handle_list_tools() {
 std::string Server::handle_call_tool(const std::string& name, const json& arguments) {
     try {
         json result = execute_tool(*client_, name, arguments);
+        // Only the table and TSV output modes produce text sent verbatim;
+        // any other result is JSON, strings included
+        std::string output = arguments.contains("output") && arguments["output"].is_string()
+            ? arguments["output"].get<std::string>() : "";
+        bool text_result = (output == "table" || output == "tsv") && result.is_string();
+        if (client_->result_store().enabled() && name != "read_result") {
+            std::string text = text_result ? result.get<std::string>() : result.dump();
+            if (client_->result_store().should_spill(text.size())) {
+                return spill_result(name, result, text).dump();
+            }
+        }
         return json({
             {"content", json::array({
-                {{"type", "text"}, {"text", result.dump(2)}}
+                {{"type", "text"}, {"text", text_result ? result.get<std::string>() : result.dump(2)}}
             })}
         }).dump();
     } catch (const std::exception& e) {
@@ -112,3 +240,91 @@ std::string Server::handle_call_tool(const std::string& name, const json& argume
         }).dump();
     }
 }
+
+// Outline of a value: scalars as-is (long strings cut), containers by size
+static json describe_shape(const json& value, int depth) {
+    if (value.is_array()) {
+        json shape = {{"type", "array"}, {"items", value.size()}};
+        if (depth > 0 && !value.empty()) shape["first"] = describe_shape(value.front(), depth - 1);
+        return shape;
+    }
+    if (value.is_object()) {
+        if (depth == 0) return {{"type", "object"}, {"keys", value.size()}};
+        json shape = json::object();
+        for (const auto& [key, item] : value.items()) shape[key] = describe_shape(item, depth - 1);
+        return shape;
+    }
+    if (value.is_string() && value.get_ref<const std::string&>().size() > 80) {
+        return value.get_ref<const std::string&>().substr(0, 77) + "...";
+    }
+    return value;
+}
+
+json Server::spill_result(const std::string& name, const json& result, const std::string& text) {
+    json resource = client_->result_store().store(name, text);
+    json summary = {
+        {"spilled", true},
+        {"message", "The result (" + std::to_string(text.size()) + " bytes) was written to a file. "
+                    "Read it in byte ranges with resources/read or the read_result tool."},
+        {"resource", resource["uri"]},
+        {"path", resource["path"]},
+        {"bytes", text.size()},
+        {"shape", describe_shape(result, 2)}
+    };
+
+    json content = json::array({{{"type", "text"}, {"text", summary.dump(2)}}});
+    if (resource_links_) {
+        content.push_back({
+            {"type", "resource_link"},
+            {"uri", resource["uri"]},
+            {"name", name + " result"},
+            {"mimeType", "application/json"},
+            {"size", text.size()}
+        });
+    }
+    return {{"content", content}};
+}
+
+json Server::handle_read_resource(const json& params) {
+    std::string uri = params.value("uri", "");
+    uint64_t offset = params.value("offset", static_cast<uint64_t>(0));
+    uint64_t length = params.value("length", DEFAULT_READ_BYTES);
+
+    // Ranges may also be given in the URI: pwndoc://results/ID?offset=N&length=N
+    size_t query = uri.find('?');
+    if (query != std::string::npos) {
+        std::string parameters = uri.substr(query + 1);
+        uri.resize(query);
+        size_t start = 0;
+        while (start < parameters.size()) {
+            size_t end = parameters.find('&', start);
+            if (end == std::string::npos) end = parameters.size();
+            std::string pair = parameters.substr(start, end - start);
+            size_t equals = pair.find('=');
+            if (equals != std::string::npos) {
+                std::string key = pair.substr(0, equals);
+                uint64_t value = std::strtoull(pair.c_str() + equals + 1, nullptr, 10);
+                if (key == "offset") offset = value;
+                if (key == "length") length = value;
+            }
+            start = end + 1;
+        }
+    }
+    length = std::clamp<uint64_t>(length, 1024, MAX_READ_BYTES);
+
+    json range = client_->result_store().read(uri, offset, length);
+    bool whole = range["offset"] == 0 && range["next_offset"].is_null();
+    return {
+        {"contents", json::array({{
+            {"uri", uri},
+            {"mimeType", whole ? "application/json" : "text/plain"},
+            {"text", range["text"]}
+        }})},
+        {"_meta", {
+            {"offset", range["offset"]},
+            {"length", range["length"]},
+            {"total_bytes", range["total_bytes"]},
+            {"next_offset", range["next_offset"]}
+        }}
+    };
+}
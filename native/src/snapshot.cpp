@@ -0,0 +1,876 @@
+#include "snapshot.hpp"
+#include "base64.hpp"
+#include "bulk.hpp"
+#include "id_map.hpp"
+#include "parallel.hpp"
+#include "progress.hpp"
+#include <zlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <vector>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Archive I/O
+// ============================================================================
+
+SnapshotWriter::SnapshotWriter(const std::string& path) : path_(path) {
+    fs::path parent = fs::path(path).parent_path();
+    if (!parent.empty()) fs::create_directories(parent);
+
+    // Written under a temporary name and renamed by close()
+    file_ = gzopen((path + ".part").c_str(), "wb6");
+    if (!file_) {
+        throw PwnDocError("Cannot write " + path + ".part");
+    }
+    gzbuffer(file_, 256 * 1024);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    if (file_) {
+        gzclose(file_);
+        std::error_code ignored;
+        fs::remove(path_ + ".part", ignored);
+    }
+}
+
+void SnapshotWriter::write_line(const std::string& line) {
+    if (gzwrite(file_, line.data(), static_cast<unsigned>(line.size())) != static_cast<int>(line.size()) ||
+        gzputc(file_, '\n') != '\n') {
+        int code = 0;
+        throw PwnDocError(std::string("Failed writing snapshot: ") + gzerror(file_, &code));
+    }
+    bytes_ += line.size() + 1;
+}
+
+void SnapshotWriter::write(const std::string& type, const std::string& data, const json& context) {
+    json head = context;
+    head["type"] = type;
+    std::string line = head.dump();
+    line.pop_back();
+    line += ",\"data\":";
+    line += data;
+    line += '}';
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_line(line);
+    ++counts_[type];
+    Sha256& sha = checksums_[type];
+    sha.update(data.data(), data.size());
+    sha.update("\n", 1);
+    ++records_;
+}
+
+json SnapshotWriter::close(const json& extra) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    json checksums = json::object();
+    for (auto& [type, sha] : checksums_) {
+        checksums[type] = sha.hex_digest();
+    }
+
+    json manifest = extra;
+    manifest["type"] = "manifest";
+    manifest["counts"] = counts_;
+    manifest["sha256"] = checksums;
+    manifest["records"] = records_;
+    manifest["uncompressed_bytes"] = bytes_;
+    write_line(manifest.dump());
+
+    int result = gzclose(file_);
+    file_ = nullptr;
+    if (result != Z_OK) {
+        throw PwnDocError("Failed to finish snapshot " + path_);
+    }
+    fs::rename(path_ + ".part", path_);
+    return manifest;
+}
+
+SnapshotReader::SnapshotReader(const std::string& path) {
+    // gzread passes uncompressed input through unchanged
+    file_ = gzopen(path.c_str(), "rb");
+    if (!file_) {
+        throw PwnDocError("Cannot open snapshot " + path);
+    }
+    gzbuffer(file_, 256 * 1024);
+}
+
+SnapshotReader::~SnapshotReader() {
+    if (file_) gzclose(file_);
+}
+
+bool SnapshotReader::next(std::string& line) {
+    line.clear();
+    while (true) {
+        size_t newline = buffer_.find('\n', pos_);
+        if (newline != std::string::npos) {
+            line.append(buffer_, pos_, newline - pos_);
+            pos_ = newline + 1;
+            bytes_read_ += line.size() + 1;
+            return true;
+        }
+        line.append(buffer_, pos_, std::string::npos);
+        buffer_.clear();
+        pos_ = 0;
+
+        if (eof_) {
+            bytes_read_ += line.size();
+            return !line.empty();
+        }
+
+        buffer_.resize(256 * 1024);
+        int got = gzread(file_, &buffer_[0], static_cast<unsigned>(buffer_.size()));
+        if (got < 0) {
+            int code = 0;
+            throw PwnDocError(std::string("Failed reading snapshot: ") + gzerror(file_, &code));
+        }
+        buffer_.resize(static_cast<size_t>(got));
+        if (got == 0) eof_ = true;
+    }
+}
+
+// ============================================================================
+// Snapshot tool
+// ============================================================================
+
+namespace {
+
+const int SNAPSHOT_VERSION = 1;
+const size_t MAX_REPORTED_ERRORS = 100;
+
+// String field of an object, or `fallback` when it is missing, null or not a string
+std::string string_field(const json& object, const char* key, const std::string& fallback) {
+    if (!object.is_object()) return fallback;
+    auto it = object.find(key);
+    return it != object.end() && it->is_string() ? it->get<std::string>() : fallback;
+}
+
+/**
+ * Collection endpoint backed up as one record per entry
+ */
+struct Collection {
+    const char* type;
+    const char* endpoint;
+};
+
+// Reference data first, so a restore can read the archive front to back
+const std::vector<Collection> COLLECTIONS = {
+    {"language", "/api/data/languages"},
+    {"audit_type", "/api/data/audit-types"},
+    {"vulnerability_type", "/api/data/vulnerability-types"},
+    {"vulnerability_category", "/api/data/vulnerability-categories"},
+    {"section", "/api/data/sections"},
+    {"custom_field", "/api/data/custom-fields"},
+    {"role", "/api/data/roles"},
+    {"settings", "/api/settings"},
+    {"template", "/api/templates"},
+    {"client", "/api/clients"},
+    {"company", "/api/companies"},
+    {"vulnerability", "/api/vulnerabilities"},
+};
+
+std::string utc_timestamp(const char* format) {
+    std::time_t now = std::time(nullptr);
+    std::ostringstream oss;
+    oss << std::put_time(std::gmtime(&now), format);
+    return oss.str();
+}
+
+/**
+ * Serialized template entry with its file embedded as base64
+ */
+std::string template_record(PwnDocClient& client, const json& entry, const std::string& scratch_dir) {
+    std::string id = entry.value("_id", "");
+    fs::path scratch = fs::path(scratch_dir) / (".snapshot-template-" + id);
+    client.download("/api/templates/download/" + id, scratch.string());
+
+    std::string data = entry.dump();
+    data.pop_back();
+    data += entry.empty() ? "\"file\":\"" : ",\"file\":\"";
+    try {
+        base64_append_file(scratch.string(), data);
+    } catch (...) {
+        fs::remove(scratch);
+        throw;
+    }
+    fs::remove(scratch);
+    data += "\"}";
+    return data;
+}
+
+} // namespace
+
+json snapshot(PwnDocClient& client, const json& args) {
+    std::string path = args.value("output_path", "");
+    if (path.empty()) path = client.config().get_download_dir() + "/";
+    if (path.back() == '/' || path.back() == '\\' || fs::is_directory(path)) {
+        path = (fs::path(path) / ("pwndoc-snapshot-" + utc_timestamp("%Y%m%d-%H%M%S") + ".ndjson.gz")).string();
+    }
+    bool include_images = args.value("include_images", true);
+    int limit = client.config().max_concurrency;
+    size_t max_parallel = static_cast<size_t>(std::clamp(args.value("max_parallel", limit), 1, limit));
+
+    auto start = std::chrono::steady_clock::now();
+    SnapshotWriter writer(path);
+    std::string scratch_dir = fs::path(path).parent_path().string();
+    if (scratch_dir.empty()) scratch_dir = ".";
+    writer.write("header", json({
+        {"format", "pwndoc-snapshot"},
+        {"version", SNAPSHOT_VERSION},
+        {"created_at", utc_timestamp("%Y-%m-%dT%H:%M:%SZ")},
+        {"source", client.config().url}
+    }).dump());
+
+    std::mutex errors_mutex;
+    json errors = json::array();
+    size_t error_count = 0;
+    auto record_error = [&](const std::string& type, const std::string& id, const std::string& message) {
+        std::lock_guard<std::mutex> lock(errors_mutex);
+        ++error_count;
+        if (errors.size() < MAX_REPORTED_ERRORS) {
+            json error = {{"type", type}, {"error", message}};
+            if (!id.empty()) error["id"] = id;
+            errors.push_back(std::move(error));
+        }
+    };
+
+    // Collections: small lists fetched concurrently, one record per entry
+    parallel_for(COLLECTIONS.size(), max_parallel, [&](size_t i) {
+        const Collection& collection = COLLECTIONS[i];
+        try {
+            json datas = response_datas(client.get(collection.endpoint));
+            if (!datas.is_array()) {
+                writer.write(collection.type, datas.dump());
+                return;
+            }
+            for (const auto& entry : datas) {
+                if (std::string(collection.type) == "template") {
+                    try {
+                        writer.write(collection.type, template_record(client, entry, scratch_dir));
+                    } catch (const std::exception& e) {
+                        record_error(collection.type, entry.value("_id", ""), e.what());
+                    }
+                } else {
+                    writer.write(collection.type, entry.dump());
+                }
+            }
+        } catch (const std::exception& e) {
+            record_error(collection.type, "", e.what());
+        }
+    });
+
+    // Audits: each worker fetches one complete audit at a time and writes
+    // the audit, the images it references, then its findings in order
+    json audits = response_datas(client.get("/api/audits"));
+    std::vector<std::string> audit_ids;
+    if (audits.is_array()) {
+        for (const auto& audit : audits) {
+            if (audit.contains("_id")) audit_ids.push_back(audit["_id"].get<std::string>());
+        }
+    }
+
+    ProgressSink progress = ProgressScope::current();
+    std::mutex progress_mutex;
+    std::set<std::string> images_seen;
+    size_t audits_done = 0;
+    parallel_for(audit_ids.size(), max_parallel, [&](size_t i) {
+        const std::string& audit_id = audit_ids[i];
+        try {
+            json audit = response_datas(client.get("/api/audits/" + audit_id));
+            json findings = audit.is_object() && audit.contains("findings") ? std::move(audit["findings"]) : json::array();
+            if (audit.is_object()) audit.erase("findings");
+            writer.write("audit", audit.dump());
+
+            if (include_images) {
+                std::set<std::string> referenced;
+                collect_image_ids(audit, referenced);
+                collect_image_ids(findings, referenced);
+                for (const auto& image_id : referenced) {
+                    {
+                        std::lock_guard<std::mutex> lock(progress_mutex);
+                        if (!images_seen.insert(image_id).second) continue;
+                    }
+                    try {
+                        json image = response_datas(client.get("/api/images/" + image_id));
+                        writer.write("image", image.dump(), {{"audit_id", audit_id}});
+                    } catch (const std::exception& e) {
+                        record_error("image", image_id, e.what());
+                    }
+                }
+            }
+
+            for (size_t index = 0; index < findings.size(); ++index) {
+                writer.write("finding", findings[index].dump(), {{"audit_id", audit_id}, {"index", index}});
+            }
+        } catch (const std::exception& e) {
+            record_error("audit", audit_id, e.what());
+        }
+
+        std::lock_guard<std::mutex> lock(progress_mutex);
+        ++audits_done;
+        progress(static_cast<double>(audits_done), static_cast<double>(audit_ids.size()),
+                 "Saved " + std::to_string(audits_done) + " of " + std::to_string(audit_ids.size()) + " audits");
+    });
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    json manifest = writer.close({
+        {"format", "pwndoc-snapshot"},
+        {"version", SNAPSHOT_VERSION},
+        {"elapsed_ms", elapsed.count()},
+        {"errors", error_count}
+    });
+
+    return {
+        {"path", fs::absolute(path).string()},
+        {"bytes", fs::file_size(path)},
+        {"uncompressed_bytes", manifest["uncompressed_bytes"]},
+        {"records", manifest["records"]},
+        {"counts", manifest["counts"]},
+        {"sha256", manifest["sha256"]},
+        {"elapsed_ms", elapsed.count()},
+        {"errors", errors},
+        {"error_count", error_count}
+    };
+}
+
+// ============================================================================
+// Restore tool
+// ============================================================================
+
+namespace {
+
+const size_t RESTORE_CHUNK_RECORDS = 256;
+const size_t RESTORE_CHUNK_BYTES = 32 * 1024 * 1024;
+
+/**
+ * Archive record with its data parsed
+ */
+struct Record {
+    std::string type;
+    json context;
+    json data;
+};
+
+/**
+ * Split a record line into its top-level fields and the raw data text.
+ * Context values are ids and numbers, so the first ,"data": is the
+ * separator. Returns false for records without data (the manifest).
+ */
+bool split_record(const std::string& line, json& head, std::string& data) {
+    size_t separator = line.find(",\"data\":");
+    if (separator == std::string::npos) {
+        head = json::parse(line);
+        return false;
+    }
+    head = json::parse(line.substr(0, separator) + "}");
+    data.assign(line, separator + 8, line.size() - separator - 9);
+    return true;
+}
+
+// Fields the server assigns, or that name users of the source instance
+json restorable(json object) {
+    if (!object.is_object()) return object;
+    for (const char* key : {"_id", "__v", "createdAt", "updatedAt", "identifier", "creator",
+                            "collaborators", "reviewers"}) {
+        object.erase(key);
+    }
+    return object;
+}
+
+// Replace populated references ({_id, ...}) by their id, at any depth
+void reference_ids(json& value) {
+    if (value.is_object()) {
+        for (auto& [key, item] : value.items()) {
+            if ((key == "client" || key == "company" || key == "template" || key == "customField") &&
+                item.is_object() && item.contains("_id")) {
+                item = item["_id"];
+            } else {
+                reference_ids(item);
+            }
+        }
+    } else if (value.is_array()) {
+        for (auto& item : value) reference_ids(item);
+    }
+}
+
+/**
+ * Fields identifying an entry across instances, used to reuse existing
+ * reference data instead of creating duplicates
+ */
+const std::map<std::string, std::vector<const char*>> NATURAL_KEYS = {
+    {"language", {"locale"}},
+    {"audit_type", {"name"}},
+    {"vulnerability_type", {"name", "locale"}},
+    {"vulnerability_category", {"name"}},
+    {"section", {"field", "locale"}},
+    {"custom_field", {"label", "display", "fieldType"}},
+    {"template", {"name", "ext"}},
+    {"client", {"email"}},
+    {"company", {"name"}},
+};
+
+std::string natural_key(const std::string& type, const json& entry) {
+    auto it = NATURAL_KEYS.find(type);
+    if (it == NATURAL_KEYS.end() || !entry.is_object()) return "";
+    std::string key;
+    bool any = false;
+    for (const char* field : it->second) {
+        auto value = entry.find(field);
+        if (value != entry.end() && !value->is_null()) any = true;
+        key += (value == entry.end() ? std::string("null") : value->dump()) + '\x1f';
+    }
+    return any ? key : "";
+}
+
+/**
+ * Keys under which an entry can match an existing one. A vulnerability
+ * template has one per locale of its details (title and locale).
+ */
+std::vector<std::string> natural_keys(const std::string& type, const json& entry) {
+    std::vector<std::string> keys;
+    if (type != "vulnerability") {
+        std::string key = natural_key(type, entry);
+        if (!key.empty()) keys.push_back(std::move(key));
+        return keys;
+    }
+    if (!entry.is_object() || !entry.contains("details") || !entry["details"].is_array()) return keys;
+    for (const auto& detail : entry["details"]) {
+        if (!detail.is_object() || !detail.contains("title") || !detail["title"].is_string()) continue;
+        keys.push_back(detail["title"].dump() + '\x1f' + detail.value("locale", json()).dump());
+    }
+    return keys;
+}
+
+const char* collection_endpoint(const std::string& type) {
+    for (const auto& collection : COLLECTIONS) {
+        if (type == collection.type) return collection.endpoint;
+    }
+    throw PwnDocError("Snapshot record type '" + type + "' cannot be restored");
+}
+
+std::string created_id(const json& response) {
+    json datas = response_datas(response);
+    if (datas.is_object() && datas.contains("audit")) datas = datas["audit"];
+    return datas.is_object() && datas.contains("_id") ? datas["_id"].get<std::string>() : "";
+}
+
+/**
+ * Finding created by a restore, kept to restore the order of its audit
+ */
+struct RestoredFinding {
+    size_t index;
+    std::string finding_id;  // empty if the server did not return it
+};
+
+/**
+ * Streams the archive once per dependency level and restores the records of
+ * that level in pipelined chunks, tallying outcomes per record type
+ */
+class Restorer {
+public:
+    Restorer(PwnDocClient& client, const std::string& path, size_t max_parallel, bool reuse_existing)
+        : client_(client), path_(path), max_parallel_(max_parallel), reuse_existing_(reuse_existing),
+          progress_(ProgressScope::current()) {}
+
+    /**
+     * Check the header, the manifest and the per-type checksums; returns the header
+     */
+    json verify() {
+        SnapshotReader reader(path_);
+        std::map<std::string, Sha256> checksums;
+        std::map<std::string, size_t> counts;
+        json header, manifest, head;
+        std::string line, data;
+        while (reader.next(line)) {
+            if (line.empty()) continue;
+            if (!split_record(line, head, data)) {
+                if (head.value("type", "") == "manifest") manifest = head;
+                continue;
+            }
+            std::string type = head.value("type", "");
+            if (type == "header") header = json::parse(data);
+            Sha256& sha = checksums[type];
+            sha.update(data.data(), data.size());
+            sha.update("\n", 1);
+            ++counts[type];
+        }
+
+        if (header.value("format", "") != "pwndoc-snapshot") {
+            throw PwnDocError(path_ + " is not a PwnDoc snapshot");
+        }
+        if (header.value("version", 0) > SNAPSHOT_VERSION) {
+            throw PwnDocError("Snapshot version " + std::to_string(header.value("version", 0)) + " is not supported");
+        }
+        if (manifest.is_null()) {
+            throw PwnDocError("Snapshot has no manifest; the archive is incomplete");
+        }
+        json expected_counts = manifest.value("counts", json::object());
+        json expected_sha = manifest.value("sha256", json::object());
+        // Every type listed in the manifest must be present in full, so a
+        // type missing from the archive is caught as well as an altered one
+        for (auto& [type, count] : expected_counts.items()) {
+            auto sha = checksums.find(type);
+            if (sha == checksums.end()) {
+                throw PwnDocError("Snapshot is missing its '" + type + "' records");
+            }
+            if (count.get<size_t>() != counts[type] || expected_sha.value(type, "") != sha->second.hex_digest()) {
+                throw PwnDocError("Snapshot checksum mismatch for '" + type + "' records");
+            }
+        }
+        for (const auto& [type, count] : counts) {
+            if (!expected_counts.contains(type)) {
+                throw PwnDocError("Snapshot has '" + type + "' records not listed in its manifest");
+            }
+        }
+
+        // Audits are read twice: created first, their contents written last
+        total_ = 0;
+        for (const auto& [type, count] : counts) {
+            if (type != "header") total_ += count;
+        }
+        total_ += counts["audit"];
+        return header;
+    }
+
+    /**
+     * Index existing entries of the given types by natural key
+     */
+    void load_existing(const std::vector<std::string>& types) {
+        if (!reuse_existing_) return;
+        parallel_for(types.size(), max_parallel_, [&](size_t i) {
+            json entries = response_datas(client_.get(collection_endpoint(types[i])));
+            std::map<std::string, std::string> by_key;
+            if (entries.is_array()) {
+                for (const auto& entry : entries) {
+                    if (!entry.contains("_id")) continue;
+                    for (auto& key : natural_keys(types[i], entry)) {
+                        by_key.emplace(std::move(key), entry["_id"].get<std::string>());
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            existing_[types[i]] = std::move(by_key);
+        });
+    }
+
+    /**
+     * Restore every record whose type is in `types`. `restore_one` returns
+     * the outcome recorded for the record ("created", "existing", ...).
+     */
+    void run_level(const std::set<std::string>& types,
+                   const std::function<std::string(Record&)>& restore_one) {
+        SnapshotReader reader(path_);
+        std::vector<Record> chunk;
+        size_t chunk_bytes = 0;
+        std::string line, data;
+        json head;
+
+        auto flush = [&]() {
+            if (chunk.empty()) return;
+            PipelineStats stats;
+            auto results = run_pipelined(chunk.size(), max_parallel_, [&](size_t i) {
+                return json(restore_one(chunk[i]));
+            }, stats);
+            for (size_t i = 0; i < chunk.size(); ++i) {
+                const Record& record = chunk[i];
+                std::string id = record.data.is_object() ? record.data.value("_id", "") : "";
+                if (results[i].ok) {
+                    tally(record.type, results[i].response.get<std::string>());
+                } else {
+                    tally(record.type, "failed");
+                    record_error(record.type, id, results[i].error);
+                }
+            }
+            done_ += chunk.size();
+            if (progress_) progress_(static_cast<double>(done_), static_cast<double>(total_),
+                                     "Restored " + std::to_string(done_) + " of " + std::to_string(total_) +
+                                     " records (audits count twice)");
+            chunk.clear();
+            chunk_bytes = 0;
+        };
+
+        while (reader.next(line)) {
+            if (line.empty() || !split_record(line, head, data)) continue;
+            std::string type = head.value("type", "");
+            if (!types.count(type)) continue;
+            head.erase("type");
+            chunk.push_back({type, std::move(head), json::parse(data)});
+            chunk_bytes += data.size();
+            if (chunk.size() >= RESTORE_CHUNK_RECORDS || chunk_bytes >= RESTORE_CHUNK_BYTES) flush();
+        }
+        flush();
+    }
+
+    /**
+     * Create a reference entry, or map it onto an existing one
+     */
+    std::string restore_entry(Record& record) {
+        std::string old_id = record.data.value("_id", "");
+        json data = restorable(record.data);
+        reference_ids(data);
+        ids_.remap(data);
+
+        if (record.type == "settings") {
+            client_.put("/api/settings", data);
+            return "updated";
+        }
+        if (record.type == "role") {
+            return "skipped";  // roles are defined by the server configuration
+        }
+
+        if (reuse_existing_) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& by_key = existing_[record.type];
+            for (const auto& key : natural_keys(record.type, data)) {
+                auto it = by_key.find(key);
+                if (it != by_key.end()) {
+                    if (!old_id.empty()) ids_.put(old_id, it->second);
+                    return "existing";
+                }
+            }
+        }
+
+        // Vulnerabilities are created through the bulk endpoint
+        json body = record.type == "vulnerability" ? json::array({data}) : data;
+        std::string new_id = created_id(client_.post(collection_endpoint(record.type), body));
+        if (!old_id.empty() && !new_id.empty()) ids_.put(old_id, new_id);
+        return "created";
+    }
+
+    std::string create_audit(Record& record) {
+        json create = {
+            {"name", string_field(record.data, "name", "Audit")},
+            {"language", string_field(record.data, "language", "")},
+            {"auditType", string_field(record.data, "auditType", "")}
+        };
+        std::string new_id = created_id(client_.post("/api/audits", create));
+        if (new_id.empty()) {
+            throw PwnDocError("Audit was created but its id was not returned");
+        }
+        ids_.put(record.data.value("_id", ""), new_id);
+        return "created";
+    }
+
+    std::string restore_image(Record& record) {
+        std::string old_id = record.data.value("_id", "");
+        json data = restorable(record.data);
+        ids_.remap(data);
+        std::string new_id = created_id(client_.post("/api/images", data));
+        if (!old_id.empty() && !new_id.empty()) ids_.put(old_id, new_id);
+        return "created";
+    }
+
+    /**
+     * Write an audit's general data, sections and network, or create one
+     * of its findings
+     */
+    std::string restore_audit_content(Record& record) {
+        std::string old_audit = record.type == "audit" ? record.data.value("_id", "")
+                                                       : record.context.value("audit_id", "");
+        std::string audit_id = ids_.get(old_audit);
+        if (audit_id.empty()) {
+            throw PwnDocError("Audit " + old_audit + " was not restored");
+        }
+        std::string target = "/api/audits/" + audit_id;
+
+        json data = restorable(record.data);
+        reference_ids(data);
+        ids_.remap(data);
+
+        if (record.type == "finding") {
+            // Until the server is seen returning created ids, findings of an
+            // audit are created one at a time, so that their order of
+            // creation identifies the ids that appear in the audit
+            std::unique_lock<std::mutex> serial;
+            if (!finding_ids_returned_) {
+                std::mutex* audit_lock;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    audit_lock = &audit_locks_[audit_id];
+                }
+                serial = std::unique_lock<std::mutex>(*audit_lock);
+            }
+            std::string finding_id = created_id(client_.post(target + "/findings", data));
+            if (!finding_id.empty()) finding_ids_returned_ = true;
+            std::lock_guard<std::mutex> lock(mutex_);
+            findings_[audit_id].push_back({record.context.value("index", static_cast<size_t>(0)), finding_id});
+            return "created";
+        }
+
+        json sections = data.contains("sections") ? data["sections"] : json::array();
+        json scope = data.contains("scope") ? data["scope"] : json::array();
+        data.erase("sections");
+        data.erase("scope");
+        client_.put(target + "/general", data);
+        if (!sections.empty()) client_.put(target + "/sections", {{"sections", sections}});
+        if (!scope.empty()) client_.put(target + "/network", {{"scope", scope}});
+        return "restored";
+    }
+
+    /**
+     * Put the findings of every restored audit back in archive order with
+     * one sortFindings per audit; returns the number of audits reordered
+     */
+    size_t sort_findings() {
+        std::vector<std::string> audits;
+        for (auto& [audit_id, findings] : findings_) {
+            if (findings.size() > 1) audits.push_back(audit_id);
+        }
+
+        std::atomic<size_t> sorted{0};
+        parallel_for(audits.size(), max_parallel_, [&](size_t i) {
+            const std::string& audit_id = audits[i];
+            std::string endpoint = "/api/audits/" + audit_id;
+            auto& findings = findings_[audit_id];
+
+            try {
+                json current = response_datas(client_.get(endpoint + "/findings"));
+                std::vector<std::string> server_order;
+                for (const auto& finding : current) server_order.push_back(finding.value("_id", ""));
+
+                // Older PwnDoc versions do not return the created id: the
+                // audit was empty, so those are the ids that appeared in it,
+                // in the order the findings were created
+                std::vector<std::string> ids;
+                std::set<std::string> known;
+                std::vector<size_t> pending;
+                for (size_t j = 0; j < findings.size(); ++j) {
+                    ids.push_back(findings[j].finding_id);
+                    if (findings[j].finding_id.empty()) pending.push_back(j);
+                    else known.insert(findings[j].finding_id);
+                }
+                resolve_created_ids(current, known, pending, ids);
+                for (size_t j = 0; j < findings.size(); ++j) findings[j].finding_id = ids[j];
+                std::sort(findings.begin(), findings.end(),
+                          [](const RestoredFinding& a, const RestoredFinding& b) { return a.index < b.index; });
+
+                std::vector<std::string> order;
+                for (const auto& finding : findings) {
+                    if (!finding.finding_id.empty()) order.push_back(finding.finding_id);
+                }
+                for (const auto& id : server_order) {
+                    if (std::find(order.begin(), order.end(), id) == order.end()) order.push_back(id);
+                }
+                if (order != server_order) {
+                    client_.put(endpoint + "/sortFindings", {{"findings", order}});
+                    ++sorted;
+                }
+            } catch (const std::exception& e) {
+                record_error("finding", audit_id, std::string("Sorting failed: ") + e.what());
+            }
+        });
+        return sorted;
+    }
+
+    json tallies() const { return tallies_; }
+    json errors() const { return errors_; }
+    size_t error_count() const { return error_count_; }
+    size_t mapped_ids() const { return ids_.size(); }
+
+private:
+    PwnDocClient& client_;
+    std::string path_;
+    size_t max_parallel_;
+    bool reuse_existing_;
+    ProgressSink progress_;
+    IdMap ids_;
+
+    std::mutex mutex_;
+    std::map<std::string, std::map<std::string, std::string>> existing_;
+    std::map<std::string, std::vector<RestoredFinding>> findings_;
+    std::map<std::string, std::mutex> audit_locks_;
+    std::atomic<bool> finding_ids_returned_{false};
+    json tallies_ = json::object();
+    json errors_ = json::array();
+    size_t error_count_ = 0;
+    size_t total_ = 0;
+    size_t done_ = 0;
+
+    void tally(const std::string& type, const std::string& outcome) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        json& count = tallies_[type][outcome];
+        count = count.is_null() ? 1 : count.get<size_t>() + 1;
+    }
+
+    void record_error(const std::string& type, const std::string& id, const std::string& message) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++error_count_;
+        if (errors_.size() < MAX_REPORTED_ERRORS) {
+            json error = {{"type", type}, {"error", message}};
+            if (!id.empty()) error["id"] = id;
+            errors_.push_back(std::move(error));
+        }
+    }
+};
+
+} // namespace
+
+json restore(PwnDocClient& client, const json& args) {
+    std::string path = args["file_path"].get<std::string>();
+    bool reuse_existing = args.value("reuse_existing", true);
+    int limit = client.config().max_concurrency;
+    size_t max_parallel = static_cast<size_t>(std::clamp(args.value("max_parallel", limit), 1, limit));
+
+    auto start = std::chrono::steady_clock::now();
+    Restorer restorer(client, path, max_parallel, reuse_existing);
+    json header = restorer.verify();
+
+    json levels = json::array();
+    auto level = [&](const char* name, const std::function<void()>& run) {
+        auto level_start = std::chrono::steady_clock::now();
+        run();
+        levels.push_back({
+            {"level", name},
+            {"elapsed_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - level_start).count()}
+        });
+    };
+
+    // Each level only references ids mapped by the levels before it
+    level("reference data", [&]() {
+        restorer.load_existing({"language", "vulnerability_type", "vulnerability_category",
+                                "section", "custom_field", "template"});
+        restorer.run_level({"language", "vulnerability_type", "vulnerability_category", "section",
+                            "custom_field", "role", "settings", "template"},
+                           [&](Record& record) { return restorer.restore_entry(record); });
+    });
+    level("audit types, clients, companies and vulnerabilities", [&]() {
+        restorer.load_existing({"audit_type", "client", "company", "vulnerability"});
+        restorer.run_level({"audit_type", "client", "company", "vulnerability"},
+                           [&](Record& record) { return restorer.restore_entry(record); });
+    });
+    level("audits", [&]() {
+        restorer.run_level({"audit"}, [&](Record& record) { return restorer.create_audit(record); });
+    });
+    level("images", [&]() {
+        restorer.run_level({"image"}, [&](Record& record) { return restorer.restore_image(record); });
+    });
+    size_t sorted = 0;
+    level("audit contents and findings", [&]() {
+        restorer.run_level({"audit", "finding"},
+                           [&](Record& record) { return restorer.restore_audit_content(record); });
+        sorted = restorer.sort_findings();
+    });
+
+    return {
+        {"path", fs::absolute(path).string()},
+        {"source", header.value("source", "")},
+        {"created_at", header.value("created_at", "")},
+        {"counts", restorer.tallies()},
+        {"mapped_ids", restorer.mapped_ids()},
+        {"audits_sorted", sorted},
+        {"levels", levels},
+        {"elapsed_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count()},
+        {"errors", restorer.errors()},
+        {"error_count", restorer.error_count()}
+    };
+}
@@ -0,0 +1,98 @@
+#include "summary.hpp"
+#include "exporters.hpp"
+#include <cctype>
+#include <cmath>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Shortest run of base64 characters treated as binary data
+constexpr size_t MIN_BLOB_SIZE = 256;
+
+bool is_base64(const std::string& text, size_t start) {
+    for (size_t i = start; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (!std::isalnum(c) && c != '+' && c != '/' && c != '=' && c != '\n' && c != '\r') return false;
+    }
+    return true;
+}
+
+size_t decoded_size(const std::string& text, size_t start) {
+    size_t chars = 0;
+    for (size_t i = start; i < text.size(); ++i) {
+        if (text[i] != '=' && text[i] != '\n' && text[i] != '\r') ++chars;
+    }
+    return chars * 3 / 4;
+}
+
+json summarize_at(const json& value, const SummaryOptions& options, size_t depth) {
+    if (value.is_string()) return summarize_text(value.get<std::string>(), options.max_text);
+    if (value.is_object()) {
+        json out = json::object();
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            out[it.key()] = summarize_at(it.value(), options, depth + 1);
+        }
+        return out;
+    }
+    if (value.is_array()) {
+        if (depth > options.list_depth && !value.empty()) {
+            return "[" + std::to_string(value.size()) + (value.size() == 1 ? " item]" : " items]");
+        }
+        json out = json::array();
+        for (const auto& item : value) out.push_back(summarize_at(item, options, depth + 1));
+        return out;
+    }
+    return value;
+}
+
+} // namespace
+
+std::string summarize_text(const std::string& text, size_t max_text) {
+    if (text.compare(0, 5, "data:") == 0) {
+        size_t marker = text.find(";base64,");
+        if (marker != std::string::npos && is_base64(text, marker + 8)) {
+            return "[binary " + text.substr(5, marker - 5) + ", " +
+                   std::to_string(decoded_size(text, marker + 8)) + " bytes]";
+        }
+    }
+    if (text.size() >= MIN_BLOB_SIZE && is_base64(text, 0)) {
+        return "[binary, " + std::to_string(decoded_size(text, 0)) + " bytes]";
+    }
+
+    std::string plain = text.find('<') != std::string::npos ? strip_html(text) : text;
+
+    // Cut on a UTF-8 character boundary
+    size_t chars = 0, cut = std::string::npos;
+    for (size_t i = 0; i < plain.size(); ++i) {
+        if ((static_cast<unsigned char>(plain[i]) & 0xC0) == 0x80) continue;
+        if (chars == max_text) cut = i;
+        ++chars;
+    }
+    if (cut == std::string::npos) return plain;
+    return plain.substr(0, cut) + "... [+" + std::to_string(chars - max_text) + " chars]";
+}
+
+json summarize(const json& value, const SummaryOptions& options) {
+    return summarize_at(value, options, 0);
+}
+
+json summarize_response(const json& response, const SummaryOptions& options) {
+    json result = json::object();
+    if (response.is_object() && response.contains("datas")) {
+        for (auto it = response.begin(); it != response.end(); ++it) {
+            result[it.key()] = it.key() == "datas" ? summarize(it.value(), options) : it.value();
+        }
+    } else {
+        result = {{"datas", summarize(response, options)}};
+    }
+
+    size_t bytes = response.dump().size();
+    size_t summary_bytes = result.dump().size();
+    result["summary"] = {
+        {"bytes", bytes},
+        {"summary_bytes", summary_bytes},
+        {"reduction_percent", bytes > 0 ? std::round(1000.0 * (1.0 - static_cast<double>(summary_bytes) / bytes)) / 10.0 : 0.0}
+    };
+    return result;
+}
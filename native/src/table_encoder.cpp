@@ -0,0 +1,221 @@
+#include "table_encoder.hpp"
+#include <charconv>
+#include <stdexcept>
+#include <unordered_set>
+
+using json = nlohmann::json;
+
+namespace {
+
+const json& response_items(const json& response) {
+    if (response.is_array()) return response;
+    if (response.is_object()) {
+        auto it = response.find("datas");
+        if (it != response.end() && it->is_array()) return *it;
+    }
+    throw std::invalid_argument("Table output needs a list result");
+}
+
+const json* cell(const json& item, const std::string& column, bool value_column) {
+    if (item.is_object()) {
+        auto it = item.find(column);
+        return it != item.end() ? &*it : nullptr;
+    }
+    return value_column ? &item : nullptr;
+}
+
+// JSON string literal, escaped as json::dump() does. Text comes from parsed
+// responses, so it is already valid UTF-8.
+void append_json_string(const std::string& text, std::string& out) {
+    static const char HEX[] = "0123456789abcdef";
+    out += '"';
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out.append(text, start, i - start);
+        start = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0xF];
+        }
+    }
+    out.append(text, start, std::string::npos);
+    out += '"';
+}
+
+template <typename T>
+void append_integer(T value, std::string& out) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Compact JSON written straight into `out`; only floats go through dump()
+void append_json(const json& value, std::string& out) {
+    switch (value.type()) {
+        case json::value_t::string:
+            append_json_string(value.get_ref<const std::string&>(), out);
+            break;
+        case json::value_t::number_integer:
+            append_integer(value.get<json::number_integer_t>(), out);
+            break;
+        case json::value_t::number_unsigned:
+            append_integer(value.get<json::number_unsigned_t>(), out);
+            break;
+        case json::value_t::boolean:
+            out += value.get<bool>() ? "true" : "false";
+            break;
+        case json::value_t::null:
+            out += "null";
+            break;
+        case json::value_t::object: {
+            out += '{';
+            bool first = true;
+            for (auto it = value.begin(); it != value.end(); ++it) {
+                if (!first) out += ',';
+                first = false;
+                append_json_string(it.key(), out);
+                out += ':';
+                append_json(it.value(), out);
+            }
+            out += '}';
+            break;
+        }
+        case json::value_t::array: {
+            out += '[';
+            bool first = true;
+            for (const auto& item : value) {
+                if (!first) out += ',';
+                first = false;
+                append_json(item, out);
+            }
+            out += ']';
+            break;
+        }
+        default:
+            out += value.dump();
+    }
+}
+
+void append_tsv_text(const std::string& text, std::string& out) {
+    for (char c : text) {
+        switch (c) {
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\\': out += "\\\\"; break;
+            default: out += c;
+        }
+    }
+}
+
+void append_tsv_cell(const json* value, std::string& out) {
+    if (!value || value->is_null()) return;
+    if (value->is_string()) {
+        append_tsv_text(value->get_ref<const std::string&>(), out);
+    } else if (value->is_number_integer() || value->is_boolean()) {
+        append_json(*value, out);
+    } else {
+        // Nested values are JSON, which may hold backslashes to escape
+        std::string text;
+        append_json(*value, text);
+        append_tsv_text(text, out);
+    }
+}
+
+} // namespace
+
+std::vector<std::string> table_columns(const json& items) {
+    std::vector<std::string> columns;
+    std::unordered_set<std::string> seen;
+    bool scalars = false;
+    for (const auto& item : items) {
+        if (!item.is_object()) {
+            scalars = true;
+            continue;
+        }
+        for (auto it = item.begin(); it != item.end(); ++it) {
+            if (seen.insert(it.key()).second) columns.push_back(it.key());
+        }
+    }
+    if (scalars && !seen.count("value")) columns.push_back("value");
+    return columns;
+}
+
+void encode_table(const json& response, std::string& out) {
+    const json& items = response_items(response);
+    auto write = [&](const json& value) { append_json(value, out); };
+    auto write_key = [&](const std::string& key) { append_json_string(key, out); };
+    std::vector<std::string> columns = table_columns(items);
+    bool value_column = !columns.empty() && columns.back() == "value";
+
+    out += '{';
+    if (response.is_object()) {
+        for (auto it = response.begin(); it != response.end(); ++it) {
+            if (it.key() == "datas") continue;
+            write_key(it.key());
+            out += ':';
+            write(it.value());
+            out += ',';
+        }
+    }
+
+    out += "\"columns\":[";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i) out += ',';
+        write_key(columns[i]);
+    }
+    out += "],\"rows\":[";
+    for (size_t row = 0; row < items.size(); ++row) {
+        if (row) out += ',';
+        out += '[';
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (i) out += ',';
+            const json* value = cell(items[row], columns[i], value_column && i + 1 == columns.size());
+            if (value) write(*value);
+            else out += "null";
+        }
+        out += ']';
+    }
+    out += "]}";
+}
+
+void encode_tsv(const json& response, std::string& out) {
+    const json& items = response_items(response);
+    std::vector<std::string> columns = table_columns(items);
+    bool value_column = !columns.empty() && columns.back() == "value";
+
+    if (response.is_object()) {
+        for (auto it = response.begin(); it != response.end(); ++it) {
+            if (it.key() == "datas" || it.key() == "status") continue;
+            out += "# ";
+            out += it.key();
+            out += ": ";
+            append_tsv_cell(&it.value(), out);
+            out += '\n';
+        }
+    }
+
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i) out += '\t';
+        append_tsv_text(columns[i], out);
+    }
+    out += '\n';
+    for (const auto& item : items) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (i) out += '\t';
+            append_tsv_cell(cell(item, columns[i], value_column && i + 1 == columns.size()), out);
+        }
+        out += '\n';
+    }
+}
@@ -1,12 +1,80 @@
 #include "tools.hpp"
+#include "base64.hpp"
+#include "batch.hpp"
+#include "bulk.hpp"
+#include "exporters.hpp"
+#include "importers.hpp"
+#include "parallel.hpp"
+#include "projection.hpp"
+#include "sha256.hpp"
+#include "snapshot.hpp"
+#include "summary.hpp"
+#include "table_encoder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
 #include <stdexcept>
 
 using json = nlohmann::json;
 
+/**
+ * Get/delete tools keyed by a single id argument. The id may also be given
+ * as an array, in which case execute_tool fans out one call per id.
+ */
+static const std::map<std::string, std::string> VECTORIZED_ID_ARGS = {
+    {"get_audit", "audit_id"},
+    {"get_audit_general", "audit_id"},
+    {"get_audit_network", "audit_id"},
+    {"get_audit_sections", "audit_id"},
+    {"get_audit_findings", "audit_id"},
+    {"delete_audit", "audit_id"},
+    {"get_finding", "finding_id"},
+    {"delete_finding", "finding_id"},
+    {"delete_client", "client_id"},
+    {"delete_company", "company_id"},
+    {"delete_vulnerability", "vuln_id"},
+    {"get_user", "username"},
+    {"delete_template", "template_id"},
+    {"delete_language", "language_id"},
+    {"delete_audit_type", "audit_type_id"},
+    {"delete_vulnerability_type", "vuln_type_id"},
+    {"delete_vulnerability_category", "category_id"},
+    {"delete_section", "section_id"},
+    {"delete_custom_field", "field_id"},
+    {"get_image", "image_id"},
+    {"delete_image", "image_id"}
+};
+
+/**
+ * List tools whose array results can be paged with `limit` and `cursor`
+ */
+static const std::set<std::string> PAGED_TOOLS = {
+    "list_audits", "get_audit_findings", "list_clients", "list_companies",
+    "list_vulnerabilities", "list_users", "list_reviewers", "list_templates",
+    "list_languages", "list_audit_types", "list_vulnerability_types",
+    "list_vulnerability_categories", "list_sections", "list_custom_fields",
+    "list_roles"
+};
+
+/**
+ * Read tools returning a single API response. Like the list tools, they
+ * accept `fields` and `output`.
+ */
+static const std::set<std::string> PROJECTED_TOOLS = {
+    "get_audit", "get_audit_general", "get_audit_network", "get_audit_sections",
+    "get_finding", "get_vulnerabilities_by_locale", "export_vulnerabilities",
+    "get_vulnerability_updates", "get_current_user", "get_user", "get_totp_status",
+    "get_settings", "get_public_settings", "export_settings", "get_image"
+};
+
 json get_tool_definitions() {
-    return json::array({
+    json tools = json::array({
         // =====================================================================
-        // AUDIT TOOLS (13 tools)
+        // AUDIT TOOLS (17 tools)
         // =====================================================================
         {
             {"name", "list_audits"},
@@ -45,6 +113,24 @@ json get_tool_definitions() {
                 {"required", json::array({"name", "language", "audit_type"})}
             }}
         },
+        {
+            {"name", "clone_audit"},
+            {"description", "Copy an audit (general data, sections, network and findings) into a new audit, e.g. to start a retest. Images referenced by the copied parts are copied into the new audit. Parts are fetched in parallel and findings are created concurrently in their original order. Returns per-finding status and throughput."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"audit_id", {{"type", "string"}, {"description", "Audit to copy"}}},
+                    {"name", {{"type", "string"}, {"description", "Name of the new audit (default: source name + ' (copy)')"}}},
+                    {"language", {{"type", "string"}, {"description", "Language of the new audit (default: source language)"}}},
+                    {"audit_type", {{"type", "string"}, {"description", "Audit type of the new audit (default: source type)"}}},
+                    {"include_findings", {{"type", "boolean"}, {"description", "Copy findings (default: true)"}}},
+                    {"include_sections", {{"type", "boolean"}, {"description", "Copy sections (default: true)"}}},
+                    {"include_network", {{"type", "boolean"}, {"description", "Copy network scope (default: true)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Upper bound on concurrent requests"}}}
+                }},
+                {"required", json::array({"audit_id"})}
+            }}
+        },
         {
             {"name", "update_audit_general"},
             {"description", "Update general information of an audit."},
@@ -79,15 +165,42 @@ json get_tool_definitions() {
         },
         {
             {"name", "generate_audit_report"},
-            {"description", "Generate and download the audit report (DOCX)."},
+            {"description", "Generate the audit report (DOCX) and stream it to a local file. Returns the file path and metadata."},
             {"inputSchema", {
                 {"type", "object"},
                 {"properties", {
-                    {"audit_id", {{"type", "string"}, {"description", "The audit ID"}}}
+                    {"audit_id", {{"type", "string"}, {"description", "The audit ID"}}},
+                    {"output_path", {{"type", "string"}, {"description", "File or directory to write to (default: PWNDOC_DOWNLOAD_DIR)"}}},
+                    {"sha256", {{"type", "boolean"}, {"description", "Return the SHA-256 of the file (default: false)"}}},
+                    {"refresh", {{"type", "boolean"}, {"description", "Render again even if the audit is unchanged since a cached report (default: false)"}}}
+                }},
+                {"required", json::array({"audit_id"})}
+            }}
+        },
+        {
+            {"name", "start_report_generation"},
+            {"description", "Start rendering the audit report in the background and return a job id at once. Poll get_report_job for the file path."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"audit_id", {{"type", "string"}, {"description", "The audit ID"}}},
+                    {"output_path", {{"type", "string"}, {"description", "File or directory to write to (default: PWNDOC_DOWNLOAD_DIR)"}}},
+                    {"sha256", {{"type", "boolean"}, {"description", "Return the SHA-256 of the file (default: false)"}}},
+                    {"refresh", {{"type", "boolean"}, {"description", "Render again even if the audit is unchanged since a cached report (default: false)"}}}
                 }},
                 {"required", json::array({"audit_id"})}
             }}
         },
+        {
+            {"name", "get_report_job"},
+            {"description", "Get the status of a report job: queued, running, completed (with the file path and metadata) or failed (with the error). Without job_id, lists all jobs."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"job_id", {{"type", "string"}, {"description", "Job ID returned by start_report_generation"}}}
+                }}
+            }}
+        },
         {
             {"name", "get_audit_general"},
             {"description", "Get audit general information (dates, client, company, scope)."},
@@ -170,7 +283,7 @@ json get_tool_definitions() {
         },
 
         // =====================================================================
-        // FINDING TOOLS (9 tools)
+        // FINDING TOOLS (13 tools)
         // =====================================================================
         {
             {"name", "get_audit_findings"},
@@ -316,6 +429,78 @@ json get_tool_definitions() {
                 {"required", json::array({"audit_id", "finding_id", "destination_audit_id"})}
             }}
         },
+        {
+            {"name", "bulk_create_findings"},
+            {"description", "Create many findings in an audit with pipelined, adaptively concurrent requests. Preserves the requested order and reports per-item status and findings per second."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"audit_id", {{"type", "string"}, {"description", "The audit ID"}}},
+                    {"findings", {
+                        {"type", "array"},
+                        {"items", {{"type", "object"}}},
+                        {"description", "Findings to create (same fields as create_finding)"}
+                    }},
+                    {"sort", {{"type", "boolean"}, {"description", "Append new findings in request order with a final sort (default: true)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Upper bound on concurrent requests"}}}
+                }},
+                {"required", json::array({"audit_id", "findings"})}
+            }}
+        },
+        {
+            {"name", "bulk_update_findings"},
+            {"description", "Update many findings in an audit with pipelined, adaptively concurrent requests. Reports per-item status and findings per second."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"audit_id", {{"type", "string"}, {"description", "The audit ID"}}},
+                    {"findings", {
+                        {"type", "array"},
+                        {"items", {{"type", "object"}}},
+                        {"description", "Updates, each with a finding_id and the fields to change (same fields as update_finding)"}
+                    }},
+                    {"sort", {{"type", "boolean"}, {"description", "Reorder the updated findings to match request order (default: true)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Upper bound on concurrent requests"}}}
+                }},
+                {"required", json::array({"audit_id", "findings"})}
+            }}
+        },
+        {
+            {"name", "bulk_move_findings"},
+            {"description", "Move many findings to another audit with concurrent requests, then restore the order of both audits. Reports per-finding status."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"audit_id", {{"type", "string"}, {"description", "Source audit ID"}}},
+                    {"destination_audit_id", {{"type", "string"}, {"description", "Destination audit ID"}}},
+                    {"finding_ids", {
+                        {"type", "array"},
+                        {"items", {{"type", "string"}}},
+                        {"description", "Findings to move, in the order they should appear in the destination"}
+                    }},
+                    {"sort", {{"type", "boolean"}, {"description", "Keep the source order and append the moved findings to the destination in request order (default: true)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Upper bound on concurrent requests"}}}
+                }},
+                {"required", json::array({"audit_id", "destination_audit_id", "finding_ids"})}
+            }}
+        },
+        {
+            {"name", "export_findings"},
+            {"description", "Export the findings of all audits (or the given ones) to an NDJSON file on disk, one finding per line with its audit_id and audit_name. Audits are fetched concurrently and written as they arrive; a .gz path is compressed. Supports progress notifications."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"output_path", {{"type", "string"}, {"description", "File or directory to write to (default: timestamped file in the download directory)"}}},
+                    {"audit_ids", {
+                        {"type", "array"},
+                        {"items", {{"type", "string"}}},
+                        {"description", "Only export these audits (default: all)"}
+                    }},
+                    {"enrich", {{"type", "boolean"}, {"description", "Replace HTML fields by plain text and add cwe, cvss_score and severity (default: false)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Maximum concurrent requests (capped by PWNDOC_MAX_CONCURRENCY)"}}}
+                }}
+            }}
+        },
 
         // =====================================================================
         // CLIENT & COMPANY TOOLS (8 tools)
@@ -422,7 +607,7 @@ json get_tool_definitions() {
         },
 
         // =====================================================================
-        // VULNERABILITY TEMPLATE TOOLS (10 tools)
+        // VULNERABILITY TEMPLATE TOOLS (11 tools)
         // =====================================================================
         {
             {"name", "list_vulnerabilities"},
@@ -544,6 +729,21 @@ json get_tool_definitions() {
                 {"required", json::array({"vuln_id", "update_id"})}
             }}
         },
+        {
+            {"name", "sync_vulnerabilities"},
+            {"description", "Replicate this instance's vulnerability templates to another PwnDoc instance. Templates are matched by title and compared by a content hash per locale; only the differences are pushed, as concurrent batches of creates, updates and deletes, so re-running an up-to-date sync writes nothing. Target credentials come from a named profile or config file, never from arguments. Extra target templates are only deleted with delete_missing; run with dry_run first to preview."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"target", {{"type", "string"}, {"description", "Name of a target profile (\"targets\" in the config file, or PWNDOC_TARGET_<NAME>_URL / _TOKEN environment variables)"}}},
+                    {"target_config", {{"type", "string"}, {"description", "Path of a config file for the target instance (same format as the main config)"}}},
+                    {"delete_missing", {{"type", "boolean"}, {"description", "Delete target templates that do not exist in the source (default: false; they are listed in extra_titles instead)"}}},
+                    {"batch_size", {{"type", "integer"}, {"description", "Templates per create or delete request (default: 50)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Maximum concurrent requests (capped by PWNDOC_MAX_CONCURRENCY)"}}},
+                    {"dry_run", {{"type", "boolean"}, {"description", "Only report the changes that would be pushed (default: false)"}}}
+                }}
+            }}
+        },
 
         // =====================================================================
         // USER TOOLS (10 tools)
@@ -669,15 +869,15 @@ json get_tool_definitions() {
         },
         {
             {"name", "create_template"},
-            {"description", "Create/upload a report template."},
+            {"description", "Create/upload a report template. Pass file_path to upload a local file instead of inline base64."},
             {"inputSchema", {
                 {"type", "object"},
                 {"properties", {
-                    {"name", {{"type", "string"}, {"description", "Template name"}}},
-                    {"ext", {{"type", "string"}, {"description", "File extension (e.g., 'docx')"}}},
-                    {"file_content", {{"type", "string"}, {"description", "Base64-encoded file content"}}}
-                }},
-                {"required", json::array({"name", "ext", "file_content"})}
+                    {"name", {{"type", "string"}, {"description", "Template name (default: file name without extension)"}}},
+                    {"ext", {{"type", "string"}, {"description", "File extension (e.g., 'docx'; default: from file_path)"}}},
+                    {"file_content", {{"type", "string"}, {"description", "Base64-encoded file content"}}},
+                    {"file_path", {{"type", "string"}, {"description", "Local template file, read and encoded by the server"}}}
+                }}
             }}
         },
         {
@@ -689,7 +889,8 @@ json get_tool_definitions() {
                     {"template_id", {{"type", "string"}, {"description", "Template ID"}}},
                     {"name", {{"type", "string"}, {"description", "Template name"}}},
                     {"ext", {{"type", "string"}, {"description", "File extension"}}},
-                    {"file_content", {{"type", "string"}, {"description", "Base64-encoded file content"}}}
+                    {"file_content", {{"type", "string"}, {"description", "Base64-encoded file content"}}},
+                    {"file_path", {{"type", "string"}, {"description", "Local template file, read and encoded by the server"}}}
                 }},
                 {"required", json::array({"template_id"})}
             }}
@@ -707,11 +908,13 @@ json get_tool_definitions() {
         },
         {
             {"name", "download_template"},
-            {"description", "Download a template file."},
+            {"description", "Download a template file to local disk. Returns the file path and metadata."},
             {"inputSchema", {
                 {"type", "object"},
                 {"properties", {
-                    {"template_id", {{"type", "string"}, {"description", "Template ID to download"}}}
+                    {"template_id", {{"type", "string"}, {"description", "Template ID to download"}}},
+                    {"output_path", {{"type", "string"}, {"description", "File or directory to write to (default: PWNDOC_DOWNLOAD_DIR)"}}},
+                    {"sha256", {{"type", "boolean"}, {"description", "Return the SHA-256 of the file (default: false)"}}}
                 }},
                 {"required", json::array({"template_id"})}
             }}
@@ -1079,26 +1282,30 @@ json get_tool_definitions() {
         },
         {
             {"name", "download_image"},
-            {"description", "Download an image file."},
+            {"description", "Download an image file to local disk. Returns the file path and metadata."},
             {"inputSchema", {
                 {"type", "object"},
                 {"properties", {
-                    {"image_id", {{"type", "string"}, {"description", "Image ID to download"}}}
+                    {"image_id", {{"type", "string"}, {"description", "Image ID to download"}}},
+                    {"output_path", {{"type", "string"}, {"description", "File or directory to write to (default: PWNDOC_DOWNLOAD_DIR)"}}},
+                    {"sha256", {{"type", "boolean"}, {"description", "Return the SHA-256 of the file (default: false)"}}}
                 }},
                 {"required", json::array({"image_id"})}
             }}
         },
         {
             {"name", "upload_image"},
-            {"description", "Upload an image to an audit."},
+            {"description", "Upload an image to an audit. Pass file_path to upload a local file instead of inline base64. Images identical to an earlier upload return the existing id without uploading."},
             {"inputSchema", {
                 {"type", "object"},
                 {"properties", {
                     {"audit_id", {{"type", "string"}, {"description", "Audit ID"}}},
-                    {"name", {{"type", "string"}, {"description", "Image name"}}},
-                    {"value", {{"type", "string"}, {"description", "Base64-encoded image data"}}}
+                    {"name", {{"type", "string"}, {"description", "Image name (default: file name)"}}},
+                    {"value", {{"type", "string"}, {"description", "Base64-encoded image data"}}},
+                    {"file_path", {{"type", "string"}, {"description", "Local image file, read and encoded by the server"}}},
+                    {"force", {{"type", "boolean"}, {"description", "Upload even if identical bytes were already uploaded (default: false)"}}}
                 }},
-                {"required", json::array({"audit_id", "name", "value"})}
+                {"required", json::array({"audit_id"})}
             }}
         },
         {
@@ -1123,11 +1330,535 @@ json get_tool_definitions() {
                 {"type", "object"},
                 {"properties", json::object()}
             }}
+        },
+
+        // =====================================================================
+        // BATCH (1 tool)
+        // =====================================================================
+        {
+            {"name", "batch"},
+            {"description", "Execute many tool calls in one request with bounded parallelism. Results and errors are returned per call, in input order."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"calls", {
+                        {"type", "array"},
+                        {"description", "Tool calls to execute"},
+                        {"items", {
+                            {"type", "object"},
+                            {"properties", {
+                                {"tool", {{"type", "string"}, {"description", "Tool name"}}},
+                                {"arguments", {{"type", "object"}, {"description", "Tool arguments"}}},
+                                {"id", {{"type", "string"}, {"description", "Optional id referenced by depends_on"}}},
+                                {"depends_on", {
+                                    {"type", "array"},
+                                    {"items", {{"type", "string"}}},
+                                    {"description", "Ids of calls that must succeed before this one starts"}
+                                }}
+                            }},
+                            {"required", json::array({"tool"})}
+                        }}
+                    }},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Maximum concurrent calls (capped by PWNDOC_MAX_CONCURRENCY)"}}},
+                    {"timeout_ms", {{"type", "integer"}, {"description", "Per-call timeout in milliseconds (optional)"}}},
+                    {"fail_fast", {{"type", "boolean"}, {"description", "Skip remaining calls after the first failure (default: false)"}}}
+                }},
+                {"required", json::array({"calls"})}
+            }}
+        },
+
+        // =====================================================================
+        // RESULTS (1 tool)
+        // =====================================================================
+        {
+            {"name", "read_result"},
+            {"description", "Read a byte range of a large tool result that was written to a file (pwndoc://results/... resource). Returns the text of the range and the offset to continue from."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"uri", {{"type", "string"}, {"description", "Resource URI from the spilled result"}}},
+                    {"offset", {{"type", "integer"}, {"description", "Byte offset to start at (default: 0)"}}},
+                    {"length", {{"type", "integer"}, {"description", "Bytes to read (default: 65536, at most 4 MiB)"}}}
+                }},
+                {"required", json::array({"uri"})}
+            }}
+        },
+
+        // =====================================================================
+        // IMPORT TOOLS (3 tools)
+        // =====================================================================
+        {
+            {"name", "import_nmap"},
+            {"description", "Import an Nmap XML scan from disk into the audit network scope. The file is stream-parsed on the server side, so large scans never pass through the conversation."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"audit_id", {{"type", "string"}, {"description", "The audit ID"}}},
+                    {"file_path", {{"type", "string"}, {"description", "Path of the Nmap XML file (nmap -oX)"}}},
+                    {"scope_name", {{"type", "string"}, {"description", "Name of the scope to create or replace (default: file name)"}}},
+                    {"include_closed", {{"type", "boolean"}, {"description", "Also import closed and filtered ports (default: false)"}}},
+                    {"include_down", {{"type", "boolean"}, {"description", "Also import hosts that are not up (default: false)"}}},
+                    {"replace_all", {{"type", "boolean"}, {"description", "Drop all existing scopes of the audit instead of merging (default: false)"}}}
+                }},
+                {"required", json::array({"audit_id", "file_path"})}
+            }}
+        },
+        {
+            {"name", "import_scanner_report"},
+            {"description", "Import a Nessus (.nessus) or Burp XML export from disk as findings. Issues are grouped by plugin / issue type, matched to vulnerability templates by title, and created in pipelined batches. Supports progress notifications."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"audit_id", {{"type", "string"}, {"description", "The audit ID"}}},
+                    {"file_path", {{"type", "string"}, {"description", "Path of the scanner export"}}},
+                    {"format", {{"type", "string"}, {"enum", json::array({"auto", "nessus", "burp"})}, {"description", "Report format (default: auto)"}}},
+                    {"min_severity", {{"type", "string"}, {"enum", json::array({"info", "low", "medium", "high", "critical"})}, {"description", "Ignore issue groups below this severity (default: low)"}}},
+                    {"unmatched", {{"type", "string"}, {"enum", json::array({"create", "skip"})}, {"description", "Create findings from scanner text when no template matches, or skip them (default: create)"}}},
+                    {"sort", {{"type", "boolean"}, {"description", "Append new findings in severity order (default: true)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Maximum concurrent requests (capped by PWNDOC_MAX_CONCURRENCY)"}}},
+                    {"dry_run", {{"type", "boolean"}, {"description", "Only report what would be created (default: false)"}}}
+                }},
+                {"required", json::array({"audit_id", "file_path"})}
+            }}
+        },
+        {
+            {"name", "import_vulnerabilities"},
+            {"description", "Import vulnerability templates from a CSV or NDJSON file on disk. Rows are validated, new titles are created in batches and existing titles updated (or skipped), with concurrent requests. Rows use the API shape (with details) or flat columns: title, locale, vulnType, description, observation, remediation, references, cvssv3, priority, remediationComplexity, category."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"file_path", {{"type", "string"}, {"description", "Path of the CSV or NDJSON file"}}},
+                    {"format", {{"type", "string"}, {"enum", json::array({"csv", "ndjson"})}, {"description", "File format (default: from extension)"}}},
+                    {"locale", {{"type", "string"}, {"description", "Locale of rows without one (default: en)"}}},
+                    {"on_existing", {{"type", "string"}, {"enum", json::array({"update", "skip"})}, {"description", "What to do with titles that already exist (default: update)"}}},
+                    {"batch_size", {{"type", "integer"}, {"description", "Templates per create request (default: 50)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Maximum concurrent requests (capped by PWNDOC_MAX_CONCURRENCY)"}}},
+                    {"dry_run", {{"type", "boolean"}, {"description", "Validate and classify rows without writing (default: false)"}}}
+                }},
+                {"required", json::array({"file_path"})}
+            }}
+        },
+
+        // =====================================================================
+        // BACKUP TOOLS (2 tools)
+        // =====================================================================
+        {
+            {"name", "snapshot"},
+            {"description", "Back up the whole instance to a gzip-compressed NDJSON archive on disk: reference data, settings, templates (with their files), clients, companies, vulnerabilities, audits with their findings, and the images they reference. Records are streamed to the archive as they are fetched; a closing manifest holds per-type counts and SHA-256 checksums. Supports progress notifications."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"output_path", {{"type", "string"}, {"description", "Archive path or directory (default: timestamped file in the download directory)"}}},
+                    {"include_images", {{"type", "boolean"}, {"description", "Embed images referenced by audits and findings (default: true)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Maximum concurrent requests (capped by PWNDOC_MAX_CONCURRENCY)"}}}
+                }}
+            }}
+        },
+        {
+            {"name", "restore"},
+            {"description", "Restore a snapshot archive into this instance. The archive is verified against its manifest, then streamed once per dependency level (reference data; audit types, clients, companies and vulnerabilities; audits; images; audit contents and findings), each level created with pipelined requests. References, including image ids in HTML fields, are rewritten to the new ids. Supports progress notifications."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"file_path", {{"type", "string"}, {"description", "Path of the snapshot archive"}}},
+                    {"reuse_existing", {{"type", "boolean"}, {"description", "Map reference data, templates, clients and companies onto existing entries with the same name instead of creating duplicates (default: true)"}}},
+                    {"max_parallel", {{"type", "integer"}, {"description", "Maximum concurrent requests (capped by PWNDOC_MAX_CONCURRENCY)"}}}
+                }},
+                {"required", json::array({"file_path"})}
+            }}
+        }
+    });
+
+    // Advertise that vectorizable id arguments accept an array of ids
+    for (auto& tool : tools) {
+        auto it = VECTORIZED_ID_ARGS.find(tool["name"].get<std::string>());
+        if (it == VECTORIZED_ID_ARGS.end()) continue;
+
+        json& property = tool["inputSchema"]["properties"][it->second];
+        std::string description = property.value("description", "ID");
+        property = {
+            {"oneOf", json::array({
+                {{"type", "string"}},
+                {{"type", "array"}, {"items", {{"type", "string"}}}}
+            })},
+            {"description", description + " (or an array of IDs to process in one call)"}
+        };
+    }
+
+    // Advertise projection and output modes on read tools, and pagination
+    // on list tools
+    for (auto& tool : tools) {
+        std::string name = tool["name"].get<std::string>();
+        if (!PAGED_TOOLS.count(name) && !PROJECTED_TOOLS.count(name)) continue;
+
+        json& properties = tool["inputSchema"]["properties"];
+        properties["fields"] = {
+            {"type", "array"},
+            {"items", {{"type", "string"}}},
+            {"description", "Return only these fields, as dotted paths or JSON pointers (e.g. [\"_id\", \"name\", \"client.name\"]); arrays are traversed (optional)"}
+        };
+        properties["output"] = {
+            {"type", "string"},
+            {"enum", json::array({"full", "summary"})},
+            {"description", "summary strips HTML, shortens long text, replaces binary data with its size and nested lists with their length (default: full)"}
+        };
+        if (!PAGED_TOOLS.count(name)) continue;
+
+        properties["output"]["enum"] = json::array({"full", "summary", "table", "tsv"});
+        properties["output"]["description"] = properties["output"]["description"].get<std::string>() +
+            "; table gives the column names once followed by row arrays, tsv gives tab-separated lines";
+        properties["limit"] = {
+            {"type", "integer"},
+            {"minimum", 1},
+            {"description", "Return at most this many items, plus a nextCursor for the rest (optional)"}
+        };
+        properties["cursor"] = {
+            {"type", "string"},
+            {"description", "nextCursor of the previous page; pages are served from the list fetched by the first call (optional)"}
+        };
+    }
+
+    return tools;
+}
+
+/**
+ * Run a vectorized id tool once per id with bounded concurrency and collect
+ * the outcomes in a map keyed by id
+ */
+static json execute_vectorized(PwnDocClient& client, const std::string& name,
+                               const std::string& id_arg, const json& args) {
+    std::vector<std::string> ids;
+    for (const auto& id : args[id_arg]) {
+        std::string value = id.get<std::string>();
+        if (std::find(ids.begin(), ids.end(), value) == ids.end()) {
+            ids.push_back(value);
+        }
+    }
+
+    json results = json::object();
+    json errors = json::object();
+    std::mutex results_mutex;
+
+    parallel_for(ids.size(), static_cast<size_t>(client.config().max_concurrency), [&](size_t i) {
+        json item_args = args;
+        item_args[id_arg] = ids[i];
+        try {
+            json result = execute_tool(client, name, item_args);
+            std::lock_guard<std::mutex> lock(results_mutex);
+            results[ids[i]] = std::move(result);
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(results_mutex);
+            errors[ids[i]] = e.what();
         }
     });
+
+    return {
+        {"results", results},
+        {"errors", errors},
+        {"succeeded", results.size()},
+        {"failed", errors.size()}
+    };
+}
+
+/**
+ * Array held by a list response, either the response itself or its datas
+ */
+static const json* list_items(const json& response) {
+    if (response.is_array()) return &response;
+    if (response.is_object()) {
+        auto it = response.find("datas");
+        if (it != response.end() && it->is_array()) return &*it;
+    }
+    return nullptr;
+}
+
+/**
+ * Run a list tool one page at a time. The first call fetches the full list
+ * and keeps it in the client's list pages; cursors carry the list id,
+ * offset and page size, so following pages are sliced from memory.
+ */
+static json execute_paged(PwnDocClient& client, const std::string& name, const json& args) {
+    std::string id;
+    size_t offset = 0;
+    size_t limit = 0;
+    std::shared_ptr<const json> response;
+
+    // Checked up front: a wrongly typed value would otherwise surface as a
+    // JSON type_error from deep inside the call
+    bool has_limit = args.contains("limit") && !args["limit"].is_null();
+    bool has_cursor = args.contains("cursor") && !args["cursor"].is_null();
+    if (has_limit && (!args["limit"].is_number_integer() || args["limit"].get<long long>() < 1)) {
+        throw PwnDocError("limit must be a positive integer, got " + args["limit"].dump());
+    }
+    if (has_cursor && !args["cursor"].is_string()) {
+        throw PwnDocError("cursor must be the nextCursor string of a previous page, got " + args["cursor"].dump());
+    }
+    size_t requested = has_limit ? static_cast<size_t>(args["limit"].get<long long>()) : 0;
+
+    if (has_cursor) {
+        std::istringstream cursor;
+        try {
+            cursor.str(base64_decode(args["cursor"].get<std::string>()));
+        } catch (const std::exception&) {
+            throw PwnDocError("Invalid cursor");
+        }
+        char separator = 0;
+        if (!std::getline(cursor, id, ':') || !(cursor >> offset >> separator >> limit) || separator != ':') {
+            throw PwnDocError("Invalid cursor");
+        }
+        response = client.list_pages().find(id, name);
+        if (!response) {
+            throw PwnDocError("Cursor expired or not issued by " + name + "; list again without a cursor");
+        }
+    } else {
+        json list_args = args;
+        list_args.erase("limit");
+        list_args.erase("cursor");
+        json full = execute_tool(client, name, list_args);
+        const json* items = list_items(full);
+        if (!items || requested == 0 || items->size() <= requested) {
+            return full;
+        }
+        id = client.list_pages().store(name, std::move(full));
+        response = client.list_pages().find(id, name);
+    }
+
+    if (requested > 0) limit = requested;
+    limit = std::max<size_t>(1, limit);
+
+    const json& items = *list_items(*response);
+    size_t end = std::min(items.size(), offset + limit);
+    json page_items = offset < end ? json(items.begin() + offset, items.begin() + end) : json::array();
+
+    json page = json::object();
+    if (response->is_object()) {
+        for (auto it = response->begin(); it != response->end(); ++it) {
+            if (it.key() != "datas") page[it.key()] = it.value();
+        }
+    }
+    page["datas"] = std::move(page_items);
+    page["total"] = items.size();
+    if (end < items.size()) {
+        page["nextCursor"] = base64_encode(id + ":" + std::to_string(end) + ":" + std::to_string(limit));
+    }
+    return page;
+}
+
+/**
+ * Stream a binary endpoint to disk and describe the file instead of
+ * returning its bytes
+ */
+static json download_to_file(PwnDocClient& client, const std::string& endpoint,
+                             const json& args, const std::string& fallback_name,
+                             std::chrono::seconds timeout = std::chrono::seconds(0)) {
+    std::string path = args.value("output_path", "");
+    if (path.empty()) path = client.config().get_download_dir() + "/";
+
+    auto start = std::chrono::steady_clock::now();
+    DownloadResult download = client.download(endpoint, path, args.value("sha256", false), fallback_name, timeout);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    json result = {
+        {"path", download.path},
+        {"bytes", download.bytes},
+        {"content_type", download.content_type},
+        {"elapsed_ms", elapsed.count()}
+    };
+    if (!download.sha256.empty()) result["sha256"] = download.sha256;
+    return result;
+}
+
+/**
+ * Serialize `fields` plus one string member holding `prefix` followed by the
+ * base64 encoding of a local file. The file is encoded straight into the
+ * request body, so its contents never pass through a JSON value.
+ */
+static std::string file_upload_body(const json& fields, const std::string& key,
+                                    const std::string& prefix, const std::string& path) {
+    std::string body = fields.dump();
+    body.pop_back();
+    if (!fields.empty()) body += ',';
+    body += json(key).dump() + ":\"" + prefix;
+    base64_append_file(path, body);
+    body += "\"}";
+    return body;
+}
+
+/**
+ * MIME type for the data URI of an uploaded image, from its extension
+ */
+static std::string image_mime_type(const std::string& path) {
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (ext == ".jpg" || ext == ".jpeg") return "image/jpeg";
+    if (ext == ".gif") return "image/gif";
+    if (ext == ".svg") return "image/svg+xml";
+    if (ext == ".webp") return "image/webp";
+    if (ext == ".bmp") return "image/bmp";
+    return "image/png";
+}
+
+/**
+ * Digest of a report's inputs: the audit as returned by the API and its
+ * template's listing entry (_id, name and ext). The template's file is not
+ * covered; update_template and delete_template clear the report cache.
+ */
+static std::string report_key(PwnDocClient& client, const std::string& audit_id) {
+    json audit = response_datas(client.get("/api/audits/" + audit_id));
+
+    json template_entry = audit.is_object() && audit.contains("template") ? audit["template"] : json();
+    if (template_entry.is_string()) {
+        // The listing entry tells templates apart, not versions of one file
+        json templates = response_datas(client.get("/api/templates"));
+        if (templates.is_array()) {
+            for (const auto& entry : templates) {
+                if (entry.is_object() && entry.value("_id", "") == template_entry.get<std::string>()) {
+                    template_entry = entry;
+                    break;
+                }
+            }
+        }
+    }
+
+    Sha256 sha;
+    std::string audit_text = audit.dump();
+    std::string template_text = template_entry.dump();
+    sha.update(audit_text.data(), audit_text.size());
+    sha.update("\n", 1);
+    sha.update(template_text.data(), template_text.size());
+    return sha.hex_digest();
+}
+
+/**
+ * Render an audit's report and stream it to disk, allowing the render the
+ * longer report timeout. Reports of unchanged audits are copied from the
+ * report cache instead of being rendered again.
+ */
+static json generate_report(PwnDocClient& client, const json& args) {
+    namespace fs = std::filesystem;
+    std::string audit_id = args["audit_id"].get<std::string>();
+    ReportCache& cache = client.report_cache();
+
+    auto start = std::chrono::steady_clock::now();
+    std::string key = cache.enabled() ? report_key(client, audit_id) : "";
+    if (!key.empty() && !args.value("refresh", false)) {
+        if (auto cached = cache.find(key)) {
+            std::string path = args.value("output_path", "");
+            if (path.empty()) path = client.config().get_download_dir() + "/";
+            bool into_directory = path.back() == '/' || path.back() == '\\' || fs::is_directory(path);
+            fs::path target = into_directory ? fs::path(path) / fs::path(*cached).filename() : fs::path(path);
+            if (target.has_parent_path()) fs::create_directories(target.parent_path());
+            fs::copy_file(*cached, target, fs::copy_options::overwrite_existing);
+
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            json result = {
+                {"path", fs::absolute(target).string()},
+                {"bytes", fs::file_size(target)},
+                {"content_type", target.extension() == ".docx"
+                    ? "application/vnd.openxmlformats-officedocument.wordprocessingml.document"
+                    : "application/octet-stream"},
+                {"elapsed_ms", elapsed.count()},
+                {"cached", true}
+            };
+            if (args.value("sha256", false)) result["sha256"] = Sha256::hash_file(target.string());
+            return result;
+        }
+    }
+
+    json result = download_to_file(client, "/api/audits/" + audit_id + "/generate", args,
+                                   "report-" + audit_id + ".docx",
+                                   std::chrono::seconds(client.config().report_timeout));
+    if (!key.empty()) {
+        cache.store(key, result["path"].get<std::string>());
+        result["cached"] = false;
+    }
+    return result;
+}
+
+/**
+ * SHA-256 of the bytes behind an inline base64 image (optionally a data URI),
+ * or an empty string when the value does not decode
+ */
+static std::string image_digest(const std::string& value) {
+    size_t comma = value.compare(0, 5, "data:") == 0 ? value.find(',') : std::string::npos;
+    size_t start = comma == std::string::npos ? 0 : comma + 1;
+    std::string bytes(value.size() - start + 3, '\0');
+    try {
+        size_t size = base64_decode(value.data() + start, value.size() - start,
+                                    reinterpret_cast<uint8_t*>(&bytes[0]));
+        return Sha256::hash(bytes.data(), size);
+    } catch (const std::invalid_argument&) {
+        return "";
+    }
+}
+
+/**
+ * GET an object and remember it so later updates can be reduced to a patch
+ */
+static json get_and_cache(PwnDocClient& client, const std::string& endpoint) {
+    json response = client.get(endpoint);
+    if (ProjectionScope::current()) return response;
+    client.object_cache().store(endpoint, response_datas(response));
+    return response;
+}
+
+/**
+ * Remember each finding of a finding list under its own endpoint
+ */
+static void cache_findings(PwnDocClient& client, const std::string& audit_id, const json& findings) {
+    // Projected findings are partial and must not serve as the last known state
+    if (!findings.is_array() || ProjectionScope::current()) return;
+    for (const auto& finding : findings) {
+        if (finding.is_object() && finding.contains("_id")) {
+            client.object_cache().store(
+                "/api/audits/" + audit_id + "/findings/" + finding["_id"].get<std::string>(), finding);
+        }
+    }
 }
 
 json execute_tool(PwnDocClient& client, const std::string& name, const json& args) {
+    auto vectorized = VECTORIZED_ID_ARGS.find(name);
+    if (vectorized != VECTORIZED_ID_ARGS.end() &&
+        args.contains(vectorized->second) && args[vectorized->second].is_array()) {
+        return execute_vectorized(client, name, vectorized->second, args);
+    }
+    bool read_tool = PAGED_TOOLS.count(name) || PROJECTED_TOOLS.count(name);
+    if (read_tool && args.contains("output") && args["output"] != "full") {
+        json tool_args = args;
+        tool_args.erase("output");
+        if (args["output"] == "summary") {
+            SummaryOptions options;
+            options.max_text = static_cast<size_t>(std::max(1, client.config().summary_text_chars));
+            return summarize_response(execute_tool(client, name, tool_args), options);
+        }
+        if (PAGED_TOOLS.count(name) && (args["output"] == "table" || args["output"] == "tsv")) {
+            json response = execute_tool(client, name, tool_args);
+            if (!list_items(response)) {
+                throw PwnDocError(name + " did not return a list");
+            }
+            // Text results are passed to the client as they are
+            std::string text;
+            if (args["output"] == "table") encode_table(response, text);
+            else encode_tsv(response, text);
+            return text;
+        }
+        throw PwnDocError(PAGED_TOOLS.count(name) ? "output must be one of: full, summary, table, tsv"
+                                                  : "output must be one of: full, summary");
+    }
+    if (PAGED_TOOLS.count(name) && (args.contains("limit") || args.contains("cursor"))) {
+        return execute_paged(client, name, args);
+    }
+    if (read_tool && args.contains("fields")) {
+        FieldProjection projection(args["fields"]);
+        json tool_args = args;
+        tool_args.erase("fields");
+        if (projection.empty()) return execute_tool(client, name, tool_args);
+        ProjectionScope scope(projection);
+        return execute_tool(client, name, tool_args);
+    }
+
     // =========================================================================
     // AUDIT TOOLS
     // =========================================================================
@@ -1135,7 +1866,13 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
         return client.get("/api/audits");
     }
     if (name == "get_audit") {
-        return client.get("/api/audits/" + args["audit_id"].get<std::string>());
+        std::string audit_id = args["audit_id"].get<std::string>();
+        json response = client.get("/api/audits/" + audit_id);
+        json datas = response_datas(response);
+        if (datas.is_object() && datas.contains("findings")) {
+            cache_findings(client, audit_id, datas["findings"]);
+        }
+        return response;
     }
     if (name == "create_audit") {
         json data = {
@@ -1149,17 +1886,40 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
         std::string audit_id = args["audit_id"].get<std::string>();
         json data = args;
         data.erase("audit_id");
-        return client.put("/api/audits/" + audit_id + "/general", data);
+        return client.put_changes("/api/audits/" + audit_id + "/general", data);
     }
     if (name == "delete_audit") {
-        client.del("/api/audits/" + args["audit_id"].get<std::string>());
+        std::string audit_id = args["audit_id"].get<std::string>();
+        client.del("/api/audits/" + audit_id);
+        client.image_index().remove_audit(audit_id);
         return {{"success", true}, {"message", "Audit deleted"}};
     }
     if (name == "generate_audit_report") {
-        return client.get("/api/audits/" + args["audit_id"].get<std::string>() + "/generate");
+        return generate_report(client, args);
+    }
+    if (name == "start_report_generation") {
+        std::string audit_id = args["audit_id"].get<std::string>();
+        // A second request for the same audit and destination joins the running job
+        std::string key = audit_id + "|" + args.value("output_path", "");
+        json info = {{"audit_id", audit_id}};
+        std::string job_id = client.report_jobs().submit(key, info, [&client, args]() {
+            return generate_report(client, args);
+        });
+        return *client.report_jobs().status(job_id);
+    }
+    if (name == "get_report_job") {
+        if (!args.contains("job_id")) {
+            return {{"jobs", client.report_jobs().list()}};
+        }
+        std::string job_id = args["job_id"].get<std::string>();
+        auto status = client.report_jobs().status(job_id);
+        if (!status) {
+            throw NotFoundError("Unknown report job: " + job_id);
+        }
+        return *status;
     }
     if (name == "get_audit_general") {
-        return client.get("/api/audits/" + args["audit_id"].get<std::string>() + "/general");
+        return get_and_cache(client, "/api/audits/" + args["audit_id"].get<std::string>() + "/general");
     }
     if (name == "get_audit_network") {
         return client.get("/api/audits/" + args["audit_id"].get<std::string>() + "/network");
@@ -1174,20 +1934,23 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
         return client.put("/api/audits/" + args["audit_id"].get<std::string>() + "/updateReadyForReview", {{"state", args["state"]}});
     }
     if (name == "get_audit_sections") {
-        return client.get("/api/audits/" + args["audit_id"].get<std::string>() + "/sections");
+        return get_and_cache(client, "/api/audits/" + args["audit_id"].get<std::string>() + "/sections");
     }
     if (name == "update_audit_sections") {
-        return client.put("/api/audits/" + args["audit_id"].get<std::string>() + "/sections", args["sections"]);
+        return client.put_changes("/api/audits/" + args["audit_id"].get<std::string>() + "/sections", args["sections"]);
     }
 
     // =========================================================================
     // FINDING TOOLS
     // =========================================================================
     if (name == "get_audit_findings") {
-        return client.get("/api/audits/" + args["audit_id"].get<std::string>() + "/findings");
+        std::string audit_id = args["audit_id"].get<std::string>();
+        json response = client.get("/api/audits/" + audit_id + "/findings");
+        cache_findings(client, audit_id, response_datas(response));
+        return response;
     }
     if (name == "get_finding") {
-        return client.get("/api/audits/" + args["audit_id"].get<std::string>() + "/findings/" + args["finding_id"].get<std::string>());
+        return get_and_cache(client, "/api/audits/" + args["audit_id"].get<std::string>() + "/findings/" + args["finding_id"].get<std::string>());
     }
     if (name == "create_finding") {
         std::string audit_id = args["audit_id"].get<std::string>();
@@ -1201,7 +1964,13 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
         json data = args;
         data.erase("audit_id");
         data.erase("finding_id");
-        return client.put("/api/audits/" + audit_id + "/findings/" + finding_id, data);
+        // Field-by-field edits queued behind an in-flight write to this finding
+        // become one PUT, carrying only the fields that differ from the last
+        // fetched state
+        std::string endpoint = "/api/audits/" + audit_id + "/findings/" + finding_id;
+        return client.write_coalescer().submit(endpoint, data, [&](const json& patch) {
+            return client.put_changes(endpoint, patch);
+        });
     }
     if (name == "delete_finding") {
         client.del("/api/audits/" + args["audit_id"].get<std::string>() + "/findings/" + args["finding_id"].get<std::string>());
@@ -1223,6 +1992,21 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
     if (name == "move_finding") {
         return client.post("/api/audits/" + args["audit_id"].get<std::string>() + "/findings/" + args["finding_id"].get<std::string>() + "/move/" + args["destination_audit_id"].get<std::string>(), json::object());
     }
+    if (name == "bulk_move_findings") {
+        return bulk_move_findings(client, args);
+    }
+    if (name == "export_findings") {
+        return export_findings(client, args);
+    }
+    if (name == "clone_audit") {
+        return clone_audit(client, args);
+    }
+    if (name == "bulk_create_findings") {
+        return bulk_create_findings(client, args);
+    }
+    if (name == "bulk_update_findings") {
+        return bulk_update_findings(client, args);
+    }
 
     // =========================================================================
     // CLIENT & COMPANY TOOLS
@@ -1298,6 +2082,9 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
     if (name == "merge_vulnerability") {
         return client.post("/api/vulnerabilities/" + args["vuln_id"].get<std::string>() + "/merge/" + args["update_id"].get<std::string>(), json::object());
     }
+    if (name == "sync_vulnerabilities") {
+        return sync_vulnerabilities(client, args);
+    }
 
     // =========================================================================
     // USER TOOLS
@@ -1343,6 +2130,17 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
         return client.get("/api/templates");
     }
     if (name == "create_template") {
+        if (args.contains("file_path")) {
+            std::string path = args["file_path"].get<std::string>();
+            std::filesystem::path file(path);
+            std::string ext = file.extension().string();
+            if (!ext.empty()) ext.erase(0, 1);
+            json data = {
+                {"name", args.value("name", file.stem().string())},
+                {"ext", args.value("ext", ext)}
+            };
+            return client.post_raw("/api/templates", file_upload_body(data, "file", "", path));
+        }
         json data = {
             {"name", args["name"]},
             {"ext", args["ext"]},
@@ -1354,18 +2152,31 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
         std::string template_id = args["template_id"].get<std::string>();
         json data = args;
         data.erase("template_id");
+        if (data.contains("file_path")) {
+            std::string path = data["file_path"].get<std::string>();
+            data.erase("file_path");
+            data.erase("file_content");
+            json result = client.put_raw("/api/templates/" + template_id, file_upload_body(data, "file", "", path));
+            client.report_cache().clear();
+            return result;
+        }
         if (data.contains("file_content")) {
             data["file"] = data["file_content"];
             data.erase("file_content");
         }
-        return client.put("/api/templates/" + template_id, data);
+        json result = client.put("/api/templates/" + template_id, data);
+        client.report_cache().clear();
+        return result;
     }
     if (name == "delete_template") {
         client.del("/api/templates/" + args["template_id"].get<std::string>());
+        client.report_cache().clear();
         return {{"success", true}, {"message", "Template deleted"}};
     }
     if (name == "download_template") {
-        return client.get("/api/templates/download/" + args["template_id"].get<std::string>());
+        std::string template_id = args["template_id"].get<std::string>();
+        return download_to_file(client, "/api/templates/download/" + template_id, args,
+                                "template-" + template_id);
     }
     if (name == "get_settings") {
         return client.get("/api/settings");
@@ -1517,18 +2328,69 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
         return client.get("/api/images/" + args["image_id"].get<std::string>());
     }
     if (name == "download_image") {
-        return client.get("/api/images/download/" + args["image_id"].get<std::string>());
+        std::string image_id = args["image_id"].get<std::string>();
+        return download_to_file(client, "/api/images/download/" + image_id, args, "image-" + image_id);
     }
     if (name == "upload_image") {
-        json data = {
-            {"auditId", args["audit_id"]},
-            {"name", args["name"]},
-            {"value", args["value"]}
-        };
-        return client.post("/api/images", data);
+        std::string audit_id = args["audit_id"].get<std::string>();
+        bool from_file = args.contains("file_path");
+        std::string path = from_file ? args["file_path"].get<std::string>() : "";
+
+        // Identical bytes already uploaded in this scope are reused by id
+        std::string digest;
+        if (client.image_index().enabled() && !args.value("force", false)) {
+            digest = from_file ? Sha256::hash_file(path) : image_digest(args.value("value", ""));
+        }
+        if (!digest.empty()) {
+            if (auto existing = client.image_index().find(audit_id, digest)) {
+                // The image may have been deleted outside this server: check
+                // it still exists, and upload again if it does not
+                try {
+                    FieldProjection projection(json::array({"_id"}));
+                    ProjectionScope scope(projection);
+                    client.get("/api/images/" + *existing);
+                    return {
+                        {"status", "success"},
+                        {"datas", {{"_id", *existing}}},
+                        {"deduplicated", true},
+                        {"sha256", digest}
+                    };
+                } catch (const NotFoundError&) {
+                    client.image_index().remove_image(*existing);
+                }
+            }
+        }
+
+        json response;
+        if (from_file) {
+            json data = {
+                {"auditId", audit_id},
+                {"name", args.value("name", std::filesystem::path(path).filename().string())}
+            };
+            std::string prefix = "data:" + image_mime_type(path) + ";base64,";
+            response = client.post_raw("/api/images", file_upload_body(data, "value", prefix, path));
+        } else {
+            json data = {
+                {"auditId", audit_id},
+                {"name", args["name"]},
+                {"value", args["value"]}
+            };
+            response = client.post("/api/images", data);
+        }
+
+        if (!digest.empty()) {
+            json datas = response_datas(response);
+            if (datas.is_object() && datas.contains("_id") && datas["_id"].is_string()) {
+                client.image_index().store(audit_id, digest, datas["_id"].get<std::string>());
+            }
+            response["sha256"] = digest;
+        }
+        return response;
     }
     if (name == "delete_image") {
-        client.del("/api/images/" + args["image_id"].get<std::string>());
+        std::string image_id = args["image_id"].get<std::string>();
+        client.del("/api/images/" + image_id);
+        client.image_index().remove_image(image_id);
         return {{"success", true}, {"message", "Image deleted"}};
     }
 
@@ -1541,5 +2403,43 @@ json execute_tool(PwnDocClient& client, const std::string& name, const json& arg
         return {{"error", "get_statistics not yet implemented in C++ - use Python version"}};
     }
 
+    // =========================================================================
+    // BATCH
+    // =========================================================================
+    if (name == "batch") {
+        return execute_batch(client, args);
+    }
+
+    // =========================================================================
+    // RESULTS
+    // =========================================================================
+    if (name == "read_result") {
+        uint64_t length = std::clamp<uint64_t>(args.value("length", static_cast<uint64_t>(64 * 1024)), 1024, 4 * 1024 * 1024);
+        return client.result_store().read(args["uri"].get<std::string>(), args.value("offset", static_cast<uint64_t>(0)), length);
+    }
+
+    // =========================================================================
+    // IMPORT TOOLS
+    // =========================================================================
+    if (name == "import_nmap") {
+        return import_nmap(client, args);
+    }
+    if (name == "import_scanner_report") {
+        return import_scanner_report(client, args);
+    }
+    if (name == "import_vulnerabilities") {
+        return import_vulnerabilities(client, args);
+    }
+
+    // =========================================================================
+    // BACKUP TOOLS
+    // =========================================================================
+    if (name == "snapshot") {
+        return snapshot(client, args);
+    }
+    if (name == "restore") {
+        return restore(client, args);
+    }
+
     throw std::runtime_error("Unknown tool: " + name);
 }
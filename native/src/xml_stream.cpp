@@ -0,0 +1,274 @@
+#include "xml_stream.hpp"
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+
+namespace {
+
+bool is_space(int c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool is_name_char(int c) {
+    return c != EOF && !is_space(c) && c != '>' && c != '/' && c != '=' &&
+           c != '<' && c != '"' && c != '\'';
+}
+
+// Code points that are not Unicode scalar values, and NUL, become U+FFFD
+void append_utf8(std::string& out, unsigned long cp) {
+    if (cp == 0 || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) cp = 0xFFFD;
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+} // namespace
+
+XmlReader::XmlReader(std::istream& in, size_t buffer_size)
+    : in_(in), buffer_(buffer_size) {}
+
+bool XmlReader::fill() {
+    consumed_ += end_;
+    pos_ = 0;
+    end_ = 0;
+    if (!in_) return false;
+    in_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    end_ = static_cast<size_t>(in_.gcount());
+    return end_ > 0;
+}
+
+int XmlReader::peek() {
+    if (pos_ == end_ && !fill()) return EOF;
+    return static_cast<unsigned char>(buffer_[pos_]);
+}
+
+int XmlReader::get() {
+    int c = peek();
+    if (c != EOF) {
+        ++pos_;
+        if (c == '\n') ++line_;
+    }
+    return c;
+}
+
+void XmlReader::expect(char c) {
+    if (get() != c) fail(std::string("expected '") + c + "'");
+}
+
+void XmlReader::skip_whitespace() {
+    while (is_space(peek())) get();
+}
+
+void XmlReader::skip_past(const std::string& terminator) {
+    // Compare the last few characters read against the terminator
+    std::string tail;
+    while (tail != terminator) {
+        int c = get();
+        if (c == EOF) fail("unterminated '" + terminator + "' construct");
+        tail += static_cast<char>(c);
+        if (tail.size() > terminator.size()) tail.erase(0, 1);
+    }
+}
+
+std::string XmlReader::read_name() {
+    std::string name;
+    while (is_name_char(peek())) name += static_cast<char>(get());
+    if (name.empty()) fail("expected a name");
+    return name;
+}
+
+void XmlReader::read_entity(std::string& out) {
+    std::string entity;
+    while (entity.size() < 12) {
+        int c = peek();
+        if (c == ';' || c == EOF || c == '<' || is_space(c)) break;
+        entity += static_cast<char>(get());
+    }
+    if (peek() != ';') {
+        // Not an entity reference: keep the text as written
+        out += '&';
+        out += entity;
+        return;
+    }
+    get();
+
+    if (entity == "lt") out += '<';
+    else if (entity == "gt") out += '>';
+    else if (entity == "amp") out += '&';
+    else if (entity == "quot") out += '"';
+    else if (entity == "apos") out += '\'';
+    else if (entity.size() > 1 && entity[0] == '#') {
+        bool hex = entity[1] == 'x' || entity[1] == 'X';
+        const char* digits = entity.c_str() + (hex ? 2 : 1);
+        char* end = nullptr;
+        errno = 0;
+        unsigned long cp = std::strtoul(digits, &end, hex ? 16 : 10);
+        bool valid = hex ? std::isxdigit(static_cast<unsigned char>(*digits)) : std::isdigit(static_cast<unsigned char>(*digits));
+        if (!valid || *end != '\0') {
+            // Not a number: keep the text as written
+            out += '&' + entity + ';';
+        } else {
+            // Overflowing references are out of range like any other
+            append_utf8(out, errno == ERANGE ? 0x110000 : cp);
+        }
+    } else {
+        out += '&' + entity + ';';
+    }
+}
+
+void XmlReader::fail(const std::string& message) const {
+    throw XmlParseError("XML parse error at line " + std::to_string(line_) + ": " + message);
+}
+
+std::string XmlReader::attribute(const std::string& key, const std::string& fallback) const {
+    for (const auto& [name, value] : attributes_) {
+        if (name == key) return value;
+    }
+    return fallback;
+}
+
+XmlReader::Event XmlReader::next() {
+    if (pending_end_) {
+        pending_end_ = false;
+        name_ = std::move(stack_.back());
+        stack_.pop_back();
+        attributes_.clear();
+        return Event::EndElement;
+    }
+
+    while (true) {
+        int c = peek();
+        if (c == EOF) {
+            if (!stack_.empty()) fail("unexpected end of input inside <" + stack_.back() + ">");
+            return Event::EndDocument;
+        }
+
+        if (c != '<') {
+            text_.clear();
+            while ((c = peek()) != EOF && c != '<') {
+                get();
+                if (c == '&') read_entity(text_);
+                else text_ += static_cast<char>(c);
+            }
+            return Event::Text;
+        }
+
+        get();
+        c = peek();
+
+        if (c == '?') {
+            skip_past("?>");
+            continue;
+        }
+
+        if (c == '!') {
+            get();
+            if (peek() == '-') {
+                expect('-');
+                expect('-');
+                skip_past("-->");
+                continue;
+            }
+            if (peek() == '[') {
+                for (char expected : std::string("[CDATA[")) expect(expected);
+                text_.clear();
+                while (true) {
+                    int d = get();
+                    if (d == EOF) fail("unterminated CDATA section");
+                    text_ += static_cast<char>(d);
+                    if (text_.size() >= 3 && text_.compare(text_.size() - 3, 3, "]]>") == 0) {
+                        text_.resize(text_.size() - 3);
+                        break;
+                    }
+                }
+                return Event::Text;
+            }
+            // DOCTYPE, possibly with an internal subset in brackets
+            int brackets = 0;
+            while (true) {
+                int d = get();
+                if (d == EOF) fail("unterminated declaration");
+                if (d == '[') ++brackets;
+                else if (d == ']') --brackets;
+                else if (d == '>' && brackets <= 0) break;
+            }
+            continue;
+        }
+
+        attributes_.clear();
+
+        if (c == '/') {
+            get();
+            name_ = read_name();
+            skip_whitespace();
+            expect('>');
+            if (stack_.empty() || stack_.back() != name_) {
+                fail("unexpected </" + name_ + ">");
+            }
+            stack_.pop_back();
+            return Event::EndElement;
+        }
+
+        name_ = read_name();
+        while (true) {
+            skip_whitespace();
+            c = peek();
+            if (c == '/') {
+                get();
+                expect('>');
+                stack_.push_back(name_);
+                pending_end_ = true;
+                return Event::StartElement;
+            }
+            if (c == '>') {
+                get();
+                stack_.push_back(name_);
+                return Event::StartElement;
+            }
+
+            std::string key = read_name();
+            skip_whitespace();
+            expect('=');
+            skip_whitespace();
+            int quote = get();
+            if (quote != '"' && quote != '\'') fail("expected quoted value for attribute " + key);
+            std::string value;
+            while ((c = get()) != quote) {
+                if (c == EOF) fail("unterminated attribute value");
+                if (c == '&') read_entity(value);
+                else value += static_cast<char>(c);
+            }
+            attributes_.emplace_back(std::move(key), std::move(value));
+        }
+    }
+}
+
+std::string XmlReader::read_text() {
+    std::string content;
+    size_t target = depth();
+    while (depth() >= target) {
+        Event event = next();
+        if (event == Event::Text) content += text_;
+        else if (event == Event::EndDocument) break;
+    }
+    return content;
+}
+
+void XmlReader::skip_element() {
+    size_t target = depth();
+    while (depth() >= target) {
+        if (next() == Event::EndDocument) break;
+    }
+}
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""sync-vulns against two local mock PwnDoc instances.
+
+Covers the create, update, delete (opt-in) and no-op paths of the diff,
+checking the target's templates and the writes it received.
+
+    python3 tests/test_sync_vulns.py build/pwndoc-mcp-server
+"""
+
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+class MockPwnDoc:
+    """Vulnerability template endpoints of a PwnDoc instance"""
+
+    def __init__(self):
+        self.templates = {}
+        self.writes = []
+        self.next_id = 0
+        self.lock = threading.Lock()
+        mock = self
+
+        class Handler(BaseHTTPRequestHandler):
+            def log_message(self, *args):
+                pass
+
+            def reply(self, code, datas):
+                body = json.dumps({"status": "success" if code == 200 else "error", "datas": datas}).encode()
+                self.send_response(code)
+                self.send_header("Content-Type", "application/json")
+                self.send_header("Content-Length", str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def handle_any(self, method):
+                length = int(self.headers.get("Content-Length") or 0)
+                body = json.loads(self.rfile.read(length) or b"null")
+                # The client prefixes /api to endpoints that already carry it
+                path = self.path.split("?")[0]
+                while path.startswith("/api/"):
+                    path = path[4:]
+                with mock.lock:
+                    code, datas = mock.route(method, path, body)
+                self.reply(code, datas)
+
+            def do_GET(self):
+                self.handle_any("GET")
+
+            def do_POST(self):
+                self.handle_any("POST")
+
+            def do_PUT(self):
+                self.handle_any("PUT")
+
+            def do_DELETE(self):
+                self.handle_any("DELETE")
+
+        self.server = ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+        self.url = "http://127.0.0.1:%d" % self.server.server_address[1]
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+
+    def add(self, template):
+        self.next_id += 1
+        template = dict(template, _id="%024x" % self.next_id)
+        self.templates[template["_id"]] = template
+        return template["_id"]
+
+    def route(self, method, path, body):
+        if path == "/users/login":
+            return 200, {"token": "token"}
+        if path == "/users/me":
+            return 200, {"username": "admin"}
+        if path == "/vulnerabilities":
+            if method == "GET":
+                return 200, list(self.templates.values())
+            if method == "POST":
+                self.writes.append(("create", len(body)))
+                for template in body:
+                    self.add(template)
+                return 200, {"created": len(body), "duplicates": 0}
+            if method == "DELETE":
+                self.writes.append(("delete", len(body["vulnIds"])))
+                for vuln_id in body["vulnIds"]:
+                    self.templates.pop(vuln_id, None)
+                return 200, "Vulnerabilities deleted successfully"
+        match = re.match(r"^/vulnerabilities/(\w+)$", path)
+        if match and method == "PUT":
+            if match.group(1) not in self.templates:
+                return 404, "Vulnerability not found"
+            self.writes.append(("update", 1))
+            self.templates[match.group(1)].update(body)
+            return 200, "Vulnerability updated successfully"
+        return 404, "Not found"
+
+    def titles(self):
+        return sorted(t["details"][0]["title"] for t in self.templates.values())
+
+
+def template(title, description):
+    return {"cvssv3": "", "priority": 2, "remediationComplexity": 1, "category": "Web",
+            "details": [{"locale": "en", "title": title, "vulnType": "", "description": description,
+                         "observation": "", "remediation": "", "references": []}]}
+
+
+def main():
+    binary = os.path.abspath(sys.argv[1])
+    source, target = MockPwnDoc(), MockPwnDoc()
+    failures = []
+
+    def check(label, condition):
+        print(("ok   " if condition else "FAIL ") + label)
+        if not condition:
+            failures.append(label)
+
+    with tempfile.TemporaryDirectory() as home:
+        env = dict(os.environ, HOME=home, PWNDOC_URL=source.url, PWNDOC_TOKEN="token",
+                   PWNDOC_TARGET_STAGING_URL=target.url, PWNDOC_TARGET_STAGING_TOKEN="token")
+
+        def sync(*options):
+            del target.writes[:]
+            run = subprocess.run([binary, "sync-vulns", "--target", "staging"] + list(options),
+                                 env=env, stdin=subprocess.DEVNULL, capture_output=True, text=True, timeout=60)
+            if run.returncode != 0:
+                print(run.stdout + run.stderr)
+            return run
+
+        sql = source.add(template("SQL Injection", "<p>Unsanitized input</p>"))
+        source.add(template("Cross-Site Scripting", "<p>Reflected</p>"))
+
+        run = sync()
+        check("create: exit code", run.returncode == 0)
+        check("create: templates copied", target.titles() == ["Cross-Site Scripting", "SQL Injection"])
+        check("create: one batched create", target.writes == [("create", 2)])
+
+        source.templates[sql]["details"][0]["description"] = "<p>Parameterize queries</p>"
+        run = sync()
+        check("update: exit code", run.returncode == 0)
+        check("update: one update", target.writes == [("update", 1)])
+        updated = [t for t in target.templates.values() if t["details"][0]["title"] == "SQL Injection"]
+        check("update: description replaced",
+              len(updated) == 1 and updated[0]["details"][0]["description"] == "<p>Parameterize queries</p>")
+
+        target.add(template("Legacy Finding", "<p>Only on the target</p>"))
+        run = sync()
+        check("extra: kept without --delete-missing", target.writes == [] and "Legacy Finding" in target.titles())
+        check("extra: listed in the output", "Legacy Finding" in run.stdout)
+
+        run = sync("--delete-missing", "--dry-run")
+        check("delete: dry run writes nothing", run.returncode == 0 and target.writes == [])
+
+        run = sync("--delete-missing")
+        check("delete: exit code", run.returncode == 0)
+        check("delete: one batched delete", target.writes == [("delete", 1)])
+        check("delete: extra template removed", target.titles() == ["Cross-Site Scripting", "SQL Injection"])
+
+        run = sync("--delete-missing")
+        check("no-op: exit code", run.returncode == 0)
+        check("no-op: no writes", target.writes == [])
+
+    source.server.shutdown()
+    target.server.shutdown()
+    if failures:
+        print("%d check(s) failed" % len(failures))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())